@@ -1,8 +1,40 @@
 #include "buffer.h"
+#include "internal.h"
+#include "render_state.h"
+#include <algorithm>
+#include <iterator>
 
 using namespace framework;
+using internal::align_up;
 
-Buffer::Buffer(Buffer &&object) noexcept : id(object.id), type(object.type) {
+// Large enough for any vertex, index or uniform buffer offset alignment
+const uint32_t STREAM_REGION_ALIGNMENT = 256;
+
+IndexData::IndexData(
+  const std::vector<uint32_t> &indices, uint32_t vertex_count
+) {
+  if (vertex_count <= 1 << 16) {
+    std::vector<uint16_t> narrow(indices.begin(), indices.end());
+    *this = IndexData::of(std::span<const uint16_t>(narrow));
+  } else {
+    *this = IndexData::of(std::span<const uint32_t>(indices));
+  }
+}
+
+Buffer::Buffer(BufferType type, BufferUsage usage, uint32_t size) :
+  type(type), usage(usage), size(0), capacity(size) {
+  glCreateBuffers(1, &id);
+  glNamedBufferData(id, size, nullptr, static_cast<GLenum>(usage));
+}
+
+Buffer::Buffer(Buffer &&object) noexcept :
+  id(object.id), type(object.type), usage(object.usage),
+  index_type(object.index_type), size(object.size),
+  capacity(object.capacity),
+  staging(std::move(object.staging)),
+  dirty_ranges(std::move(object.dirty_ranges)),
+  flush_stats(object.flush_stats),
+  flush_stats_frame(object.flush_stats_frame) {
   object.id = 0;
 }
 
@@ -13,3 +45,164 @@ Buffer::~Buffer() {
 void Buffer::bind() const {
   glBindBuffer(static_cast<GLenum>(type), id);
 }
+
+void Buffer::bind_base(uint32_t binding) const {
+  bind_base(type, binding);
+}
+
+void Buffer::bind_base(BufferType target, uint32_t binding) const {
+  glBindBufferBase(static_cast<GLenum>(target), binding, id);
+}
+
+void Buffer::reserve(uint32_t bytes) {
+  if (bytes <= capacity) return;
+
+  uint32_t new_id;
+  glCreateBuffers(1, &new_id);
+  glNamedBufferData(new_id, bytes, nullptr, static_cast<GLenum>(usage));
+
+  // Migrate the contents on the GPU, without a round trip through the CPU
+  if (size > 0) glCopyNamedBufferSubData(id, new_id, 0, 0, size);
+
+  glDeleteBuffers(1, &id);
+  id = new_id;
+  capacity = bytes;
+}
+
+void Buffer::grow(uint32_t bytes) {
+  reserve(std::max(bytes, capacity * 2));
+}
+
+void Buffer::write_bytes(uint32_t offset, std::span<const std::byte> data) {
+  if (data.empty()) return;
+
+  uint32_t begin = offset;
+  uint32_t end = offset + data.size();
+
+  if (end > capacity) grow(end);
+  size = std::max(size, end);
+
+  if (staging.size() < capacity) staging.resize(capacity);
+  std::ranges::copy(data, staging.begin() + begin);
+
+  // Merge with every pending range that overlaps or touches [begin, end)
+  auto next = dirty_ranges.upper_bound(end);
+  while (next != dirty_ranges.begin()) {
+    auto previous = std::prev(next);
+    if (previous->second < begin) break;
+
+    begin = std::min(begin, previous->first);
+    end = std::max(end, previous->second);
+    next = dirty_ranges.erase(previous);
+  }
+
+  dirty_ranges.emplace(begin, end);
+}
+
+void Buffer::flush() {
+  // Several flushes in one frame add up
+  auto frame = RenderState::current().frame;
+  if (flush_stats_frame != frame) {
+    flush_stats = {};
+    flush_stats_frame = frame;
+  }
+
+  for (auto [begin, end] : dirty_ranges) {
+    glNamedBufferSubData(id, begin, end - begin, staging.data() + begin);
+
+    flush_stats.bytes += end - begin;
+    flush_stats.calls += 1;
+  }
+
+  dirty_ranges.clear();
+}
+
+StreamBuffer::StreamBuffer(
+  BufferType type, uint32_t region_size, uint32_t region_count
+) :
+  type(type),
+  region_size(align_up(region_size, STREAM_REGION_ALIGNMENT)),
+  region_count(region_count), region_fences(region_count, nullptr) {
+  if (region_count == 0) {
+    throw std::runtime_error("Stream buffer needs at least one region.");
+  }
+
+  auto flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+  auto total_size = this->region_size * region_count;
+
+  glCreateBuffers(1, &id);
+  glNamedBufferStorage(id, total_size, nullptr, flags);
+
+  mapped_data = static_cast<std::byte *>(
+    glMapNamedBufferRange(id, 0, total_size, flags)
+  );
+
+  if (!mapped_data) {
+    throw std::runtime_error("Failed to map stream buffer.");
+  }
+}
+
+StreamBuffer::StreamBuffer(StreamBuffer &&object) noexcept :
+  id(object.id), type(object.type), region_size(object.region_size),
+  region_count(object.region_count), region_index(object.region_index),
+  region_cursor(object.region_cursor), mapped_data(object.mapped_data),
+  region_fences(std::move(object.region_fences)) {
+  object.id = 0;
+  object.mapped_data = nullptr;
+}
+
+StreamBuffer::~StreamBuffer() {
+  for (auto fence : region_fences) {
+    if (fence) glDeleteSync(fence);
+  }
+
+  if (id) {
+    glUnmapNamedBuffer(id);
+    glDeleteBuffers(1, &id);
+  }
+}
+
+uint32_t StreamBuffer::allocate(uint32_t size) {
+  auto aligned_size = align_up(size, STREAM_REGION_ALIGNMENT);
+
+  if (region_cursor + aligned_size > region_size) {
+    throw std::runtime_error("Stream buffer region is out of space.");
+  }
+
+  // Wait until the GPU is done with the region before the first write to it
+  auto &fence = region_fences[region_index];
+  if (fence) {
+    const uint64_t timeout_nanoseconds = 1'000'000'000;
+
+    while (true) {
+      auto result = glClientWaitSync(
+        fence, GL_SYNC_FLUSH_COMMANDS_BIT, timeout_nanoseconds
+      );
+
+      if (result == GL_ALREADY_SIGNALED || result == GL_CONDITION_SATISFIED)
+        break;
+
+      if (result == GL_WAIT_FAILED) {
+        throw std::runtime_error("Failed waiting for stream buffer fence.");
+      }
+    }
+
+    glDeleteSync(fence);
+    fence = nullptr;
+  }
+
+  auto offset = region_index * region_size + region_cursor;
+  region_cursor += aligned_size;
+
+  return offset;
+}
+
+void StreamBuffer::end_frame() {
+  if (region_cursor == 0) return;
+
+  region_fences[region_index] =
+    glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+
+  region_index = (region_index + 1) % region_count;
+  region_cursor = 0;
+}
@@ -1,12 +1,23 @@
 #pragma once
 
 #include <GL/glew.h>
+#include <concepts>
+#include <cstddef>
+#include <cstring>
+#include <map>
 #include <span>
+#include <stdexcept>
+#include <vector>
 
 namespace framework {
   enum class BufferType {
     Vertex = GL_ARRAY_BUFFER,
     Index = GL_ELEMENT_ARRAY_BUFFER,
+    DrawIndirect = GL_DRAW_INDIRECT_BUFFER,
+    Uniform = GL_UNIFORM_BUFFER,
+    Storage = GL_SHADER_STORAGE_BUFFER,
+    DispatchIndirect = GL_DISPATCH_INDIRECT_BUFFER,
+    PixelUnpack = GL_PIXEL_UNPACK_BUFFER,
   };
 
   enum class BufferUsage {
@@ -15,12 +26,102 @@ namespace framework {
     Stream = GL_STREAM_DRAW,
   };
 
+  enum class IndexType {
+    UnsignedByte = GL_UNSIGNED_BYTE,
+    UnsignedShort = GL_UNSIGNED_SHORT,
+    UnsignedInt = GL_UNSIGNED_INT,
+  };
+
+  inline uint32_t index_size_of(IndexType index_type) {
+    switch (index_type) {
+      case IndexType::UnsignedByte:
+        return 1;
+      case IndexType::UnsignedShort:
+        return 2;
+      case IndexType::UnsignedInt:
+        return 4;
+    }
+
+    return 4;
+  }
+
+  template <std::unsigned_integral T> constexpr IndexType index_type_of() {
+    static_assert(sizeof(T) <= 4, "Index type must be at most 32 bits.");
+
+    if constexpr (sizeof(T) == 1) {
+      return IndexType::UnsignedByte;
+    } else if constexpr (sizeof(T) == 2) {
+      return IndexType::UnsignedShort;
+    } else {
+      return IndexType::UnsignedInt;
+    }
+  }
+
+  /// Indices stored in a type chosen at runtime
+  struct IndexData {
+    IndexType type = IndexType::UnsignedInt;
+    std::vector<std::byte> bytes;
+
+    IndexData() = default;
+
+    /// Stores `indices` in the narrowest type that can address
+    /// `vertex_count` vertices. 8-bit indices are only used when asked for
+    /// explicitly, since many drivers convert them on the CPU.
+    IndexData(const std::vector<uint32_t> &indices, uint32_t vertex_count);
+
+    template <std::unsigned_integral T>
+    static IndexData of(std::span<const T> indices) {
+      IndexData index_data;
+      index_data.type = index_type_of<T>();
+
+      auto bytes = std::as_bytes(indices);
+      index_data.bytes.assign(bytes.begin(), bytes.end());
+
+      return index_data;
+    }
+
+    uint32_t size() const {
+      return bytes.size() / index_size_of(type);
+    }
+  };
+
+  /// A buffer bound at a byte offset, used for vertex buffer bindings
+  struct BufferBinding {
+    uint32_t id;
+    uint32_t offset = 0;
+  };
+
+  /// Upload counters of every `Buffer::flush` in the frame the buffer was
+  /// last flushed in, they restart after `RenderState::end_frame`
+  struct BufferFlushStats {
+    uint32_t bytes = 0;
+    uint32_t calls = 0;
+  };
+
   struct Buffer {
     uint32_t id = 0;
     BufferType type;
+    BufferUsage usage;
+    IndexType index_type = IndexType::UnsignedInt;
+
+    // Bytes in use, and bytes allocated for the GL store
+    uint32_t size = 0;
+    uint32_t capacity = 0;
+
+    // Pending sub-range writes, kept in a CPU copy until the next flush
+    std::vector<std::byte> staging;
+    std::map<uint32_t, uint32_t> dirty_ranges;
+    BufferFlushStats flush_stats;
+    uint64_t flush_stats_frame = 0;
 
     template <typename T>
-    Buffer(BufferType type, BufferUsage usage, std::span<T> data) : type(type) {
+    Buffer(BufferType type, BufferUsage usage, std::span<T> data) :
+      type(type), usage(usage), size(sizeof(T) * data.size()),
+      capacity(sizeof(T) * data.size()) {
+      if constexpr (std::unsigned_integral<std::remove_const_t<T>>) {
+        index_type = index_type_of<std::remove_const_t<T>>();
+      }
+
       glGenBuffers(1, &id);
 
       bind();
@@ -32,18 +133,135 @@ namespace framework {
       );
     };
 
+    /// Allocates `size` bytes of uninitialized storage
+    Buffer(BufferType type, BufferUsage usage, uint32_t size);
+
+    Buffer(BufferUsage usage, const IndexData &indices) :
+      Buffer(BufferType::Index, usage, std::span(indices.bytes)) {
+      index_type = indices.type;
+    }
+
+    /// Replaces the contents of the buffer, growing it if needed
     template <typename T> void updateData(std::span<T> data) {
+      // Apply older pending writes first so they don't overwrite this data
+      flush();
+
+      auto bytes = static_cast<uint32_t>(sizeof(T) * data.size());
+      if (bytes > capacity) grow(bytes);
+
       bind();
-      glBufferSubData(
-        static_cast<GLenum>(type), 0, sizeof(T) * data.size(), data.data()
-      );
+      glBufferSubData(static_cast<GLenum>(type), 0, bytes, data.data());
+      size = bytes;
+
+      if constexpr (std::unsigned_integral<std::remove_const_t<T>>) {
+        index_type = index_type_of<std::remove_const_t<T>>();
+      }
+    }
+
+    /// Makes sure the buffer can hold `bytes` without reallocating
+    void reserve(uint32_t bytes);
+
+    /// Grows the capacity geometrically to at least `bytes`. The new store
+    /// is a new buffer object, so `id` changes and must be rebound.
+    void grow(uint32_t bytes);
+
+    /// Writes `data` starting at element `element_offset`, growing the
+    /// buffer if needed. The write is recorded and merged with other pending
+    /// writes, and uploaded on the next `flush`.
+    template <typename T>
+    void write(uint32_t element_offset, std::span<T> data) {
+      write_bytes(sizeof(T) * element_offset, std::as_bytes(data));
     }
 
+    void write_bytes(uint32_t offset, std::span<const std::byte> data);
+
+    /// Uploads all pending writes, one `glNamedBufferSubData` per merged
+    /// range. Call once per frame before drawing.
+    void flush();
+
     // Move constructor
     Buffer(Buffer &&object) noexcept;
 
     ~Buffer();
 
     void bind() const;
+
+    /// Binds the whole buffer to an indexed binding point of its own type,
+    /// e.g. `layout(std430, binding = N)` for `BufferType::Storage`
+    void bind_base(uint32_t binding) const;
+
+    /// Binds the buffer to an indexed binding point of `target`, so a vertex
+    /// buffer can also be written by a compute shader
+    void bind_base(BufferType target, uint32_t binding) const;
+  };
+
+  /// Command layout read by `glMultiDrawElementsIndirect`
+  struct DrawElementsIndirectCommand {
+    uint32_t count;
+    uint32_t instance_count = 1;
+    uint32_t first_index = 0;
+    int32_t base_vertex = 0;
+    uint32_t base_instance = 0;
+  };
+
+  /// GPU side list of draw commands, written by the CPU or by a shader
+  struct DrawIndirectBuffer {
+    Buffer buffer;
+    uint32_t command_count;
+
+    DrawIndirectBuffer(
+      BufferUsage usage, std::span<const DrawElementsIndirectCommand> commands
+    ) :
+      buffer(BufferType::DrawIndirect, usage, commands),
+      command_count(commands.size()) {}
+
+    void updateData(std::span<const DrawElementsIndirectCommand> commands) {
+      buffer.updateData(commands);
+      command_count = commands.size();
+    }
+  };
+
+  /// Persistently mapped buffer split into `region_count` regions, one per
+  /// frame in flight. Writes go straight into mapped memory, and each region
+  /// is guarded by a fence so the CPU never overwrites data the GPU is still
+  /// reading.
+  struct StreamBuffer {
+    uint32_t id = 0;
+    BufferType type;
+    uint32_t region_size;
+    uint32_t region_count;
+    uint32_t region_index = 0;
+    uint32_t region_cursor = 0;
+    std::byte *mapped_data = nullptr;
+    std::vector<GLsync> region_fences;
+
+    StreamBuffer(
+      BufferType type, uint32_t region_size, uint32_t region_count = 3
+    );
+
+    StreamBuffer(StreamBuffer &&object) noexcept;
+
+    ~StreamBuffer();
+
+    StreamBuffer(const StreamBuffer &) = delete;
+
+    StreamBuffer &operator=(const StreamBuffer &) = delete;
+
+    /// Copies `data` into the active region and returns its byte offset in
+    /// the buffer, to be used when binding the buffer.
+    template <typename T> uint32_t write(std::span<T> data) {
+      auto offset = allocate(sizeof(T) * data.size());
+      std::memcpy(mapped_data + offset, data.data(), sizeof(T) * data.size());
+
+      return offset;
+    }
+
+    /// Reserves `size` bytes in the active region, waiting for the GPU to
+    /// finish with the region first if this is its first use this frame.
+    uint32_t allocate(uint32_t size);
+
+    /// Fences the active region and moves on to the next one. Call once per
+    /// frame, after the draws reading from the active region were issued.
+    void end_frame();
   };
 }
@@ -0,0 +1,163 @@
+#include "buffer_arena.h"
+#include "internal.h"
+#include <bit>
+#include <cassert>
+#include <iterator>
+#include <limits>
+
+using namespace framework;
+using internal::align_up;
+
+static uint32_t create_storage(uint32_t capacity) {
+  uint32_t id;
+  glCreateBuffers(1, &id);
+  glNamedBufferStorage(id, capacity, nullptr, GL_DYNAMIC_STORAGE_BIT);
+
+  return id;
+}
+
+BufferArena::BufferArena(
+  BufferType type, uint32_t capacity, IndexType index_type
+) :
+  id(create_storage(capacity)), type(type), capacity(capacity),
+  index_type(index_type), free_blocks({{0, capacity}}) {}
+
+BufferArena::BufferArena(BufferArena &&arena) noexcept :
+  id(arena.id), type(arena.type), capacity(arena.capacity),
+  index_type(arena.index_type), free_blocks(std::move(arena.free_blocks)),
+  allocations(std::move(arena.allocations)) {
+  arena.id = 0;
+}
+
+BufferArena::~BufferArena() {
+  if (id) glDeleteBuffers(1, &id);
+}
+
+BufferSlice BufferArena::allocate(uint32_t size, uint32_t alignment) {
+  assert(std::has_single_bit(alignment) && "Alignment must be a power of 2");
+
+  return allocate_block(size, alignment);
+}
+
+BufferSlice BufferArena::allocate_block(uint32_t size, uint32_t alignment) {
+  assert(alignment != 0);
+
+  if (size == 0) return {.buffer = id, .offset = 0, .size = 0};
+
+  auto best_block = free_blocks.end();
+  auto best_waste = std::numeric_limits<uint32_t>::max();
+
+  for (auto block = free_blocks.begin(); block != free_blocks.end(); block++) {
+    auto [block_offset, block_size] = *block;
+    auto offset = align_up(block_offset, alignment);
+
+    if (offset + size > block_offset + block_size) continue;
+
+    // The alignment padding in front is split off as a free block, but
+    // still fragments the space so it counts towards the fit
+    auto waste = block_size - (offset - block_offset + size);
+    if (waste < best_waste) {
+      best_block = block;
+      best_waste = waste;
+    }
+  }
+
+  if (best_block == free_blocks.end()) {
+    throw std::runtime_error("Buffer arena is out of space.");
+  }
+
+  auto [block_offset, block_size] = *best_block;
+  auto offset = align_up(block_offset, alignment);
+  free_blocks.erase(best_block);
+
+  // Give back the alignment padding in front and the remainder behind
+  if (offset > block_offset) {
+    free_blocks.emplace(block_offset, offset - block_offset);
+  }
+
+  auto block_end = block_offset + block_size;
+  if (offset + size < block_end) {
+    free_blocks.emplace(offset + size, block_end - (offset + size));
+  }
+
+  allocations.emplace(offset, Allocation{.size = size, .alignment = alignment});
+
+  return {.buffer = id, .offset = offset, .size = size};
+}
+
+void BufferArena::free(const BufferSlice &slice) {
+  if (slice.size == 0) return;
+
+  auto allocation = allocations.find(slice.offset);
+  if (allocation == allocations.end() || slice.buffer != id) {
+    throw std::runtime_error("Buffer slice was not allocated from this arena."
+    );
+  }
+
+  auto offset = allocation->first;
+  auto size = allocation->second.size;
+  allocations.erase(allocation);
+
+  // Coalesce with the neighbouring free blocks
+  auto next = free_blocks.lower_bound(offset);
+  if (next != free_blocks.end() && offset + size == next->first) {
+    size += next->second;
+    next = free_blocks.erase(next);
+  }
+
+  if (next != free_blocks.begin()) {
+    auto previous = std::prev(next);
+
+    if (previous->first + previous->second == offset) {
+      offset = previous->first;
+      size += previous->second;
+      free_blocks.erase(previous);
+    }
+  }
+
+  free_blocks.emplace(offset, size);
+}
+
+std::vector<BufferRelocation> BufferArena::defragment() {
+  // Copying within one buffer is not allowed for overlapping ranges, so
+  // everything is packed into a fresh buffer instead
+  auto new_id = create_storage(capacity);
+
+  std::vector<BufferRelocation> relocations;
+  std::map<uint32_t, Allocation> new_allocations;
+  std::map<uint32_t, uint32_t> new_free_blocks;
+  uint32_t cursor = 0;
+
+  for (auto [offset, allocation] : allocations) {
+    auto new_offset = align_up(cursor, allocation.alignment);
+    if (new_offset > cursor) {
+      new_free_blocks.emplace(cursor, new_offset - cursor);
+    }
+
+    glCopyNamedBufferSubData(id, new_id, offset, new_offset, allocation.size);
+
+    relocations.push_back({
+      .from = {.buffer = id, .offset = offset, .size = allocation.size},
+      .to = {.buffer = new_id, .offset = new_offset, .size = allocation.size},
+    });
+
+    new_allocations.emplace(new_offset, allocation);
+    cursor = new_offset + allocation.size;
+  }
+
+  glDeleteBuffers(1, &id);
+  id = new_id;
+  allocations = std::move(new_allocations);
+
+  if (cursor < capacity) new_free_blocks.emplace(cursor, capacity - cursor);
+  free_blocks = std::move(new_free_blocks);
+
+  return relocations;
+}
+
+uint32_t BufferArena::free_bytes() const {
+  uint32_t bytes = 0;
+  for (auto [offset, size] : free_blocks) bytes += size;
+
+  return bytes;
+}
@@ -0,0 +1,117 @@
+#pragma once
+
+#include "framework/buffer.h"
+#include <GL/glew.h>
+#include <concepts>
+#include <cstdint>
+#include <map>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+namespace framework {
+  /// A range of bytes inside a shared GPU buffer
+  struct BufferSlice {
+    uint32_t buffer = 0;
+    uint32_t offset = 0;
+    uint32_t size = 0;
+
+    /// Index of the first `T` in the slice, usable as base vertex or first
+    /// index when drawing from the whole buffer
+    template <typename T> uint32_t first_element() const {
+      return offset / sizeof(T);
+    }
+  };
+
+  struct BufferRelocation {
+    BufferSlice from;
+    BufferSlice to;
+  };
+
+  /// One large immutable buffer that many meshes allocate slices from, so
+  /// they can share a single vertex array binding.
+  struct BufferArena {
+    struct Allocation {
+      uint32_t size;
+      uint32_t alignment;
+    };
+
+    uint32_t id = 0;
+    BufferType type;
+    uint32_t capacity;
+
+    // Type of every index stored in an index arena
+    IndexType index_type;
+
+    // Both keyed by offset, free blocks are always fully coalesced
+    std::map<uint32_t, uint32_t> free_blocks;
+    std::map<uint32_t, Allocation> allocations;
+
+    BufferArena(
+      BufferType type,
+      uint32_t capacity,
+      IndexType index_type = IndexType::UnsignedInt
+    );
+
+    BufferArena(BufferArena &&arena) noexcept;
+
+    ~BufferArena();
+
+    BufferArena(const BufferArena &) = delete;
+
+    BufferArena &operator=(const BufferArena &) = delete;
+
+    /// Best fit allocation, the slice offset is a multiple of `alignment`,
+    /// which has to be a power of 2
+    BufferSlice allocate(uint32_t size, uint32_t alignment = 1);
+
+    /// Allocates a slice aligned to `sizeof(T)` and uploads `data` to it.
+    /// The offset divided by the stride is then a valid base vertex, even
+    /// for strides that aren't a power of 2. Index arenas only take indices
+    /// of their `index_type`.
+    template <typename T> BufferSlice allocate(std::span<T> data) {
+      using Element = std::remove_const_t<T>;
+
+      if (type == BufferType::Index) {
+        bool matches = false;
+        if constexpr (std::unsigned_integral<Element> && sizeof(T) <= 4) {
+          matches = index_type_of<Element>() == index_type;
+        }
+
+        if (!matches) {
+          throw std::runtime_error("Indices don't match the arena index type.");
+        }
+      }
+
+      auto slice = allocate_block(sizeof(T) * data.size(), sizeof(T));
+      write(slice, data);
+
+      return slice;
+    }
+
+    template <typename T>
+    void write(const BufferSlice &slice, std::span<T> data) {
+      if (sizeof(T) * data.size() > slice.size) {
+        throw std::runtime_error("Data does not fit in buffer slice.");
+      }
+
+      glNamedBufferSubData(
+        id, slice.offset, sizeof(T) * data.size(), data.data()
+      );
+    }
+
+    void free(const BufferSlice &slice);
+
+    /// Packs all allocations to the start of a new buffer. Every slice
+    /// handed out before is invalidated, the returned relocations map them
+    /// to their new location.
+    std::vector<BufferRelocation> defragment();
+
+    uint32_t free_bytes() const;
+
+  private:
+    /// Best fit allocation for any nonzero alignment
+    BufferSlice allocate_block(uint32_t size, uint32_t alignment);
+  };
+}
@@ -0,0 +1,38 @@
+#include "compute_pipeline.h"
+#include "render_state.h"
+#include <array>
+
+using namespace framework;
+
+void framework::memory_barrier(Barrier barrier) {
+  glMemoryBarrier(static_cast<GLbitfield>(barrier));
+}
+
+ComputePipeline::ComputePipeline(std::shared_ptr<Shader> shader) :
+  shader(shader) {
+  std::array<int32_t, 3> size;
+  glGetProgramiv(shader->id, GL_COMPUTE_WORK_GROUP_SIZE, size.data());
+
+  work_group_size = {size[0], size[1], size[2]};
+}
+
+void ComputePipeline::bind() const {
+  RenderState::current().use_program(shader->id);
+}
+
+glm::uvec3 ComputePipeline::group_count_for(glm::uvec3 invocations) const {
+  return (invocations + work_group_size - 1u) / work_group_size;
+}
+
+void ComputePipeline::dispatch(
+  uint32_t group_count_x, uint32_t group_count_y, uint32_t group_count_z
+) const {
+  glDispatchCompute(group_count_x, group_count_y, group_count_z);
+}
+
+void ComputePipeline::dispatch_indirect(
+  const Buffer &commands, uint32_t offset
+) const {
+  glBindBuffer(GL_DISPATCH_INDIRECT_BUFFER, commands.id);
+  glDispatchComputeIndirect(offset);
+}
@@ -0,0 +1,65 @@
+#pragma once
+
+#include "framework/buffer.h"
+#include "framework/shader.h"
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+#include <cstdint>
+#include <memory>
+
+namespace framework {
+  /// Bits for `memory_barrier`, naming how the data written by a compute
+  /// shader will be read next
+  enum class Barrier : uint32_t {
+    VertexAttribute = GL_VERTEX_ATTRIB_ARRAY_BARRIER_BIT,
+    ElementArray = GL_ELEMENT_ARRAY_BARRIER_BIT,
+    Uniform = GL_UNIFORM_BARRIER_BIT,
+    TextureFetch = GL_TEXTURE_FETCH_BARRIER_BIT,
+    ShaderImageAccess = GL_SHADER_IMAGE_ACCESS_BARRIER_BIT,
+    Command = GL_COMMAND_BARRIER_BIT,
+    BufferUpdate = GL_BUFFER_UPDATE_BARRIER_BIT,
+    TextureUpdate = GL_TEXTURE_UPDATE_BARRIER_BIT,
+    ShaderStorage = GL_SHADER_STORAGE_BARRIER_BIT,
+    All = GL_ALL_BARRIER_BITS,
+  };
+
+  constexpr Barrier operator|(Barrier left, Barrier right) {
+    return static_cast<Barrier>(
+      static_cast<uint32_t>(left) | static_cast<uint32_t>(right)
+    );
+  }
+
+  /// Makes writes from earlier dispatches visible to the given kinds of reads
+  void memory_barrier(Barrier barrier);
+
+  /// Command layout read by `glDispatchComputeIndirect`
+  struct DispatchIndirectCommand {
+    uint32_t group_count_x = 1;
+    uint32_t group_count_y = 1;
+    uint32_t group_count_z = 1;
+  };
+
+  struct ComputePipeline {
+    std::shared_ptr<Shader> shader;
+
+    // `local_size_x/y/z` declared by the compute shader
+    glm::uvec3 work_group_size;
+
+    explicit ComputePipeline(std::shared_ptr<Shader> shader);
+
+    void bind() const;
+
+    /// Work groups needed to cover `invocations`, rounded up
+    glm::uvec3 group_count_for(glm::uvec3 invocations) const;
+
+    void dispatch(
+      uint32_t group_count_x,
+      uint32_t group_count_y = 1,
+      uint32_t group_count_z = 1
+    ) const;
+
+    /// Reads a `DispatchIndirectCommand` at byte `offset` of `commands`,
+    /// which may have been written by an earlier dispatch
+    void dispatch_indirect(const Buffer &commands, uint32_t offset = 0) const;
+  };
+}
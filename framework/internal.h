@@ -0,0 +1,25 @@
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+#include <type_traits>
+
+// Helpers shared by the framework's sources, not meant for the labs
+namespace framework::internal {
+  /// FNV-1a of `bytes`, continuing from `hash`
+  inline uint64_t hash_bytes(std::string_view bytes, uint64_t hash) {
+    for (auto character : bytes) {
+      hash ^= static_cast<uint8_t>(character);
+      hash *= 0x100000001b3;
+    }
+
+    return hash;
+  }
+
+  /// Rounds `value` up to a multiple of `alignment`, which doesn't have to
+  /// be a power of 2
+  template <typename T>
+  constexpr T align_up(T value, std::type_identity_t<T> alignment) {
+    return (value + alignment - 1) / alignment * alignment;
+  }
+}
@@ -0,0 +1,192 @@
+#include "mipmap.h"
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64)
+  #include <emmintrin.h>
+  #define FRAMEWORK_SSE2
+#endif
+
+using namespace framework;
+
+// Linear colors are stored as 12 bit integers between the lookups, which
+// keeps every sRGB value intact through a round trip
+static constexpr uint32_t LINEAR_STEPS = 4096;
+
+struct SrgbTables {
+  std::array<uint16_t, 256> to_linear;
+  std::array<uint8_t, LINEAR_STEPS> to_srgb;
+};
+
+static float srgb_to_linear(float color) {
+  if (color <= 0.04045f) return color / 12.92f;
+
+  return std::pow((color + 0.055f) / 1.055f, 2.4f);
+}
+
+static float linear_to_srgb(float color) {
+  if (color <= 0.0031308f) return color * 12.92f;
+
+  return 1.055f * std::pow(color, 1.f / 2.4f) - 0.055f;
+}
+
+static const SrgbTables &srgb_tables() {
+  static const SrgbTables tables = [] {
+    SrgbTables tables;
+
+    for (uint32_t i = 0; i < tables.to_linear.size(); i++) {
+      auto linear = srgb_to_linear(i / 255.f);
+      tables.to_linear[i] = std::lround(linear * (LINEAR_STEPS - 1));
+    }
+
+    for (uint32_t i = 0; i < tables.to_srgb.size(); i++) {
+      auto srgb = linear_to_srgb(i / static_cast<float>(LINEAR_STEPS - 1));
+      tables.to_srgb[i] = std::lround(srgb * 255.f);
+    }
+
+    return tables;
+  }();
+
+  return tables;
+}
+
+#ifdef FRAMEWORK_SSE2
+/// Averages two output pixels per iteration, returns the first output pixel
+/// it did not write
+static uint32_t downsample_row_sse2(
+  const uint8_t *top_row,
+  const uint8_t *bottom_row,
+  uint8_t *output_row,
+  uint32_t width,
+  uint32_t output_width
+) {
+  auto zero = _mm_setzero_si128();
+  auto rounding = _mm_set1_epi16(2);
+
+  uint32_t x = 0;
+  for (; x + 2 <= output_width && (x + 2) * 2 <= width; x += 2) {
+    auto top = _mm_loadu_si128(
+      reinterpret_cast<const __m128i *>(top_row + x * 8)
+    );
+    auto bottom = _mm_loadu_si128(
+      reinterpret_cast<const __m128i *>(bottom_row + x * 8)
+    );
+
+    // Vertical sums of input pixels 0 and 1 in `low`, 2 and 3 in `high`
+    auto low = _mm_add_epi16(
+      _mm_unpacklo_epi8(top, zero), _mm_unpacklo_epi8(bottom, zero)
+    );
+    auto high = _mm_add_epi16(
+      _mm_unpackhi_epi8(top, zero), _mm_unpackhi_epi8(bottom, zero)
+    );
+
+    // Horizontal neighbours are 8 bytes apart
+    auto first = _mm_add_epi16(low, _mm_srli_si128(low, 8));
+    auto second = _mm_add_epi16(high, _mm_srli_si128(high, 8));
+
+    auto sums = _mm_unpacklo_epi64(first, second);
+    auto averages = _mm_srli_epi16(_mm_add_epi16(sums, rounding), 2);
+
+    _mm_storel_epi64(
+      reinterpret_cast<__m128i *>(output_row + x * 4),
+      _mm_packus_epi16(averages, averages)
+    );
+  }
+
+  return x;
+}
+#endif
+
+uint32_t framework::mip_level_count(uint32_t width, uint32_t height) {
+  return std::bit_width(std::max({width, height, 1u}));
+}
+
+MipLevel framework::downsample(
+  std::span<const uint8_t> pixels, uint32_t width, uint32_t height, bool srgb
+) {
+  MipLevel level{
+    .width = std::max(width / 2, 1u),
+    .height = std::max(height / 2, 1u),
+  };
+  level.pixels.resize(level.width * level.height * 4);
+
+  auto &tables = srgb_tables();
+
+  // Odd sizes fold their last row and column into the last output pixels,
+  // so no input pixel is dropped. Edges of size 1 are repeated.
+  auto extra_column = width > 1 && width % 2 == 1;
+  auto extra_row = height > 1 && height % 2 == 1;
+
+  for (uint32_t y = 0; y < level.height; y++) {
+    auto last_row = extra_row && y == level.height - 1;
+    uint32_t row_count = last_row ? 3 : 2;
+
+    std::array<const uint8_t *, 3> rows;
+    for (uint32_t row = 0; row < rows.size(); row++) {
+      rows[row] = &pixels[std::min(y * 2 + row, height - 1) * width * 4];
+    }
+
+    auto output_row = &level.pixels[y * level.width * 4];
+
+    uint32_t x = 0;
+
+#ifdef FRAMEWORK_SSE2
+    if (!srgb && !last_row) {
+      auto sse_width = level.width - (extra_column ? 1 : 0);
+      x = downsample_row_sse2(rows[0], rows[1], output_row, width, sse_width);
+    }
+#endif
+
+    for (; x < level.width; x++) {
+      auto last_column = extra_column && x == level.width - 1;
+      uint32_t column_count = last_column ? 3 : 2;
+      auto count = row_count * column_count;
+
+      std::array<uint32_t, 3> columns;
+      for (uint32_t column = 0; column < columns.size(); column++) {
+        columns[column] = std::min(x * 2 + column, width - 1) * 4;
+      }
+
+      for (uint32_t channel = 0; channel < 4; channel++) {
+        auto linear = srgb && channel < 3;
+        uint32_t sum = 0;
+
+        for (uint32_t row = 0; row < row_count; row++) {
+          for (uint32_t column = 0; column < column_count; column++) {
+            auto sample = rows[row][columns[column] + channel];
+            sum += linear ? tables.to_linear[sample] : sample;
+          }
+        }
+
+        auto average = (sum + count / 2) / count;
+        if (linear) average = tables.to_srgb[average];
+
+        output_row[x * 4 + channel] = average;
+      }
+    }
+  }
+
+  return level;
+}
+
+std::vector<MipLevel> framework::build_mip_chain(
+  std::span<const uint8_t> pixels, uint32_t width, uint32_t height, bool srgb
+) {
+  std::vector<MipLevel> levels;
+
+  auto level_count = mip_level_count(width, height);
+  for (uint32_t level = 1; level < level_count; level++) {
+    if (levels.empty()) {
+      levels.push_back(downsample(pixels, width, height, srgb));
+    } else {
+      auto &previous = levels.back();
+      levels.push_back(
+        downsample(previous.pixels, previous.width, previous.height, srgb)
+      );
+    }
+  }
+
+  return levels;
+}
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace framework {
+  /// Levels of a full mip chain, down to 1x1
+  uint32_t mip_level_count(uint32_t width, uint32_t height);
+
+  /// RGBA8 pixels of a single mip level
+  struct MipLevel {
+    uint32_t width;
+    uint32_t height;
+    std::vector<uint8_t> pixels;
+  };
+
+  /// Halves RGBA8 `pixels` with a 2x2 box filter, widened to 3 pixels at
+  /// the last row and column of odd sizes. sRGB colors are averaged in
+  /// linear space so the smaller levels don't darken, alpha is linear.
+  MipLevel downsample(
+    std::span<const uint8_t> pixels, uint32_t width, uint32_t height, bool srgb
+  );
+
+  /// Every level after the base one, each built from the one before it
+  std::vector<MipLevel> build_mip_chain(
+    std::span<const uint8_t> pixels, uint32_t width, uint32_t height, bool srgb
+  );
+}
@@ -0,0 +1,100 @@
+#pragma once
+
+#include "framework/vertex_layout.h"
+#include <glm/glm.hpp>
+#include <glm/gtc/packing.hpp>
+#include <array>
+#include <cstdint>
+#include <cstring>
+
+namespace framework {
+  /// Vertex member holding components packed on the CPU, `Format` tells the
+  /// pipeline how to unpack them. Stored as 16 or 32 bit words so members
+  /// stay aligned without padding.
+  template <VertexFormat Format, typename Word, size_t Count = 1>
+  struct Packed {
+    std::array<Word, Count> words;
+
+    template <typename Bits> static Packed from_bits(Bits bits) {
+      static_assert(sizeof(Bits) == sizeof(words));
+
+      Packed packed;
+      std::memcpy(packed.words.data(), &bits, sizeof(bits));
+
+      return packed;
+    }
+  };
+
+  template <VertexFormat Format, typename Word, size_t Count>
+  struct vertex_format_of<Packed<Format, Word, Count>> {
+    static constexpr VertexFormat value = Format;
+  };
+
+  using Half2 = Packed<VertexFormat::Half2, uint32_t>;
+  using Half4 = Packed<VertexFormat::Half4, uint32_t, 2>;
+  using UnormByte2 = Packed<VertexFormat::UnormByte2, uint16_t>;
+  using UnormByte4 = Packed<VertexFormat::UnormByte4, uint32_t>;
+  using SnormByte2 = Packed<VertexFormat::SnormByte2, uint16_t>;
+  using SnormByte4 = Packed<VertexFormat::SnormByte4, uint32_t>;
+  using UnormShort2 = Packed<VertexFormat::UnormShort2, uint32_t>;
+  using UnormShort4 = Packed<VertexFormat::UnormShort4, uint32_t, 2>;
+  using SnormShort2 = Packed<VertexFormat::SnormShort2, uint32_t>;
+  using SnormShort4 = Packed<VertexFormat::SnormShort4, uint32_t, 2>;
+  using Unorm10_10_10_2 = Packed<VertexFormat::Unorm10_10_10_2, uint32_t>;
+  using Snorm10_10_10_2 = Packed<VertexFormat::Snorm10_10_10_2, uint32_t>;
+
+  inline Half2 pack_half(glm::vec2 value) {
+    return Half2::from_bits(glm::packHalf2x16(value));
+  }
+
+  inline Half4 pack_half(glm::vec4 value) {
+    return Half4::from_bits(glm::packHalf4x16(value));
+  }
+
+  /// Components are clamped to [0, 1]
+  inline UnormByte2 pack_unorm_byte(glm::vec2 value) {
+    return UnormByte2::from_bits(glm::packUnorm2x8(value));
+  }
+
+  inline UnormByte4 pack_unorm_byte(glm::vec4 value) {
+    return UnormByte4::from_bits(glm::packUnorm4x8(value));
+  }
+
+  /// Components are clamped to [-1, 1]
+  inline SnormByte2 pack_snorm_byte(glm::vec2 value) {
+    return SnormByte2::from_bits(glm::packSnorm2x8(value));
+  }
+
+  inline SnormByte4 pack_snorm_byte(glm::vec4 value) {
+    return SnormByte4::from_bits(glm::packSnorm4x8(value));
+  }
+
+  inline UnormShort2 pack_unorm_short(glm::vec2 value) {
+    return UnormShort2::from_bits(glm::packUnorm2x16(value));
+  }
+
+  inline UnormShort4 pack_unorm_short(glm::vec4 value) {
+    return UnormShort4::from_bits(glm::packUnorm4x16(value));
+  }
+
+  inline SnormShort2 pack_snorm_short(glm::vec2 value) {
+    return SnormShort2::from_bits(glm::packSnorm2x16(value));
+  }
+
+  inline SnormShort4 pack_snorm_short(glm::vec4 value) {
+    return SnormShort4::from_bits(glm::packSnorm4x16(value));
+  }
+
+  inline Unorm10_10_10_2 pack_unorm_10_10_10_2(glm::vec4 value) {
+    return Unorm10_10_10_2::from_bits(glm::packUnorm3x10_1x2(value));
+  }
+
+  inline Snorm10_10_10_2 pack_snorm_10_10_10_2(glm::vec4 value) {
+    return Snorm10_10_10_2::from_bits(glm::packSnorm3x10_1x2(value));
+  }
+
+  /// Unit normal in 4 bytes instead of 12, the 2 bit `w` is left at 0
+  inline Snorm10_10_10_2 pack_normal(glm::vec3 normal) {
+    return pack_snorm_10_10_10_2(glm::vec4(normal, 0.f));
+  }
+}
@@ -1,4 +1,5 @@
 #include "pipeline.h"
+#include "render_state.h"
 #include <format>
 #include <ranges>
 
@@ -42,6 +43,25 @@ uint32_t bytes_of(VertexFormat vertex_format) {
       return 16;
     case Mat4:
       return 64;
+    case Half2:
+      return 4;
+    case Half4:
+      return 8;
+    case UnormByte2:
+    case SnormByte2:
+      return 2;
+    case UnormByte4:
+    case SnormByte4:
+      return 4;
+    case UnormShort2:
+    case SnormShort2:
+      return 4;
+    case UnormShort4:
+    case SnormShort4:
+      return 8;
+    case Unorm10_10_10_2:
+    case Snorm10_10_10_2:
+      return 4;
   }
 }
 
@@ -59,6 +79,11 @@ uint32_t components_of(VertexFormat vertex_format) {
     case Byte2:
     case Short2:
     case Int2:
+    case Half2:
+    case UnormByte2:
+    case SnormByte2:
+    case UnormShort2:
+    case SnormShort2:
       return 2;
 
     case Float3:
@@ -71,6 +96,13 @@ uint32_t components_of(VertexFormat vertex_format) {
     case Byte4:
     case Short4:
     case Int4:
+    case Half4:
+    case UnormByte4:
+    case SnormByte4:
+    case UnormShort4:
+    case SnormShort4:
+    case Unorm10_10_10_2:
+    case Snorm10_10_10_2:
       return 4;
 
     case Mat4:
@@ -108,6 +140,68 @@ uint32_t gl_type_of(VertexFormat vertex_format) {
 
     case Mat4:
       return GL_FLOAT;
+
+    case Half2:
+    case Half4:
+      return GL_HALF_FLOAT;
+
+    case UnormByte2:
+    case UnormByte4:
+      return GL_UNSIGNED_BYTE;
+
+    case SnormByte2:
+    case SnormByte4:
+      return GL_BYTE;
+
+    case UnormShort2:
+    case UnormShort4:
+      return GL_UNSIGNED_SHORT;
+
+    case SnormShort2:
+    case SnormShort4:
+      return GL_SHORT;
+
+    case Unorm10_10_10_2:
+      return GL_UNSIGNED_INT_2_10_10_10_REV;
+
+    case Snorm10_10_10_2:
+      return GL_INT_2_10_10_10_REV;
+  }
+}
+
+static bool is_integer_type(uint32_t type) {
+  switch (type) {
+    case GL_INT:
+    case GL_UNSIGNED_INT:
+    case GL_SHORT:
+    case GL_UNSIGNED_SHORT:
+    case GL_BYTE:
+    case GL_UNSIGNED_BYTE:
+      return true;
+
+    default:
+      return false;
+  }
+}
+
+bool normalized_of(VertexFormat vertex_format) {
+  using enum VertexFormat;
+
+  switch (vertex_format) {
+    case UnormByte2:
+    case UnormByte4:
+    case SnormByte2:
+    case SnormByte4:
+    case UnormShort2:
+    case UnormShort4:
+    case SnormShort2:
+    case SnormShort4:
+    case Unorm10_10_10_2:
+    case Snorm10_10_10_2:
+      return true;
+
+    default:
+      return false;
   }
 }
 
@@ -171,7 +265,11 @@ Pipeline::Pipeline(
       divisor = layout.step_rate;
     }
 
+    // Matrices take one attribute slot per column
     auto attribute_count = attribute_count_of(vertex_attribute.format);
+    auto slot_components = components_of(vertex_attribute.format) /
+      attribute_count;
+    auto slot_bytes = bytes_of(vertex_attribute.format) / attribute_count;
 
     for (uint32_t i = 0; i < attribute_count; i++) {
       auto offset_location = attribute_location + i;
@@ -182,8 +280,9 @@ Pipeline::Pipeline(
 
       auto attribute = VertexAttributeLayout{
         .attribute_location = offset_location,
-        .size = components_of(vertex_attribute.format),
+        .size = slot_components,
         .type = gl_type_of(vertex_attribute.format),
+        .normalized = normalized_of(vertex_attribute.format),
         .offset = buffer->offset,
         .stride = buffer->stride,
         .buffer_index = vertex_attribute.buffer_index,
@@ -191,48 +290,124 @@ Pipeline::Pipeline(
       };
 
       vertex_layout[offset_location] = attribute;
-      buffer->offset += bytes_of(vertex_attribute.format);
+      buffer->offset += slot_bytes;
     }
   }
 
+  create_vertex_array(vertex_layout);
+}
+
+static std::shared_ptr<Shader> vertex_stage_of(
+  const ProgramPipeline &program_pipeline
+) {
+  auto vertex_stage = program_pipeline.stage(ShaderType::Vertex);
+  if (!vertex_stage) {
+    throw std::runtime_error("Program pipeline has no vertex stage.");
+  }
+
+  return vertex_stage;
+}
+
+Pipeline::Pipeline(
+  std::shared_ptr<ProgramPipeline> program_pipeline,
+  std::initializer_list<VertexAttribute> vertex_attributes,
+  PipelineOptions pipeline_options,
+  std::span<BufferLayout> buffer_layouts
+) :
+  Pipeline(
+    vertex_stage_of(*program_pipeline),
+    vertex_attributes,
+    pipeline_options,
+    buffer_layouts
+  ) {
+  this->program_pipeline = program_pipeline;
+}
+
+Pipeline::Pipeline(
+  std::shared_ptr<Shader> shader,
+  std::initializer_list<VertexBufferLayout> vertex_buffers,
+  PipelineOptions pipeline_options
+) :
+  shader(shader),
+  pipeline_options(pipeline_options), buffer_meta_data(vertex_buffers.size()) {
+  std::vector<VertexAttributeLayout> vertex_layout;
+
+  for (auto const [buffer_index, vertex_buffer] :
+       std::views::enumerate(vertex_buffers)) {
+    buffer_meta_data[buffer_index].stride = vertex_buffer.stride;
+
+    uint32_t divisor = 0;
+    if (vertex_buffer.step == VertexStep::PerInstance) {
+      divisor = vertex_buffer.step_rate;
+    }
+
+    for (auto &attribute : vertex_buffer.attributes) {
+      // Matrices take one attribute slot per column
+      auto attribute_count = attribute_count_of(attribute.format);
+      auto slot_components = components_of(attribute.format) /
+        attribute_count;
+      auto slot_bytes = bytes_of(attribute.format) / attribute_count;
+
+      for (uint32_t i = 0; i < attribute_count; i++) {
+        vertex_layout.push_back({
+          .attribute_location = attribute.location + i,
+          .size = slot_components,
+          .type = gl_type_of(attribute.format),
+          .normalized = normalized_of(attribute.format),
+          .offset = attribute.offset + i * slot_bytes,
+          .stride = vertex_buffer.stride,
+          .buffer_index = static_cast<uint32_t>(buffer_index),
+          .divisor = divisor,
+        });
+      }
+    }
+  }
+
+  create_vertex_array(vertex_layout);
+}
+
+Pipeline::Pipeline(
+  std::shared_ptr<ProgramPipeline> program_pipeline,
+  std::initializer_list<VertexBufferLayout> vertex_buffers,
+  PipelineOptions pipeline_options
+) :
+  Pipeline(
+    vertex_stage_of(*program_pipeline), vertex_buffers, pipeline_options
+  ) {
+  this->program_pipeline = program_pipeline;
+}
+
+void Pipeline::create_vertex_array(
+  std::span<const VertexAttributeLayout> vertex_layout
+) {
   glCreateVertexArrays(1, &vertex_array_id);
 
-  for (uint32_t attribute_index = 0; attribute_index < vertex_layout.size();
-       attribute_index++) {
-    auto layout = vertex_layout[attribute_index];
+  for (auto &layout : vertex_layout) {
+    auto attribute_index = layout.attribute_location;
 
     glEnableVertexArrayAttrib(vertex_array_id, attribute_index);
     glVertexArrayAttribBinding(
       vertex_array_id, attribute_index, layout.buffer_index
     );
 
-    switch (layout.type) {
-      case GL_INT:
-      case GL_UNSIGNED_INT:
-      case GL_UNSIGNED_SHORT:
-      case GL_UNSIGNED_BYTE:
-      case GL_BYTE: {
-        glVertexArrayAttribIFormat(
-          vertex_array_id,
-          attribute_index,
-          layout.size,
-          layout.type,
-          layout.offset
-        );
-        break;
-      }
-
-      default: {
-        glVertexArrayAttribFormat(
-          vertex_array_id,
-          attribute_index,
-          layout.size,
-          layout.type,
-          GL_FALSE,
-          layout.offset
-        );
-        break;
-      }
+    // Normalized integers are read as floats, the rest stay integers
+    if (is_integer_type(layout.type) && !layout.normalized) {
+      glVertexArrayAttribIFormat(
+        vertex_array_id,
+        attribute_index,
+        layout.size,
+        layout.type,
+        layout.offset
+      );
+    } else {
+      glVertexArrayAttribFormat(
+        vertex_array_id,
+        attribute_index,
+        layout.size,
+        layout.type,
+        layout.normalized ? GL_TRUE : GL_FALSE,
+        layout.offset
+      );
     }
 
     glVertexArrayBindingDivisor(
@@ -244,123 +419,29 @@ Pipeline::Pipeline(
 Pipeline::Pipeline(Pipeline &&pipeline) noexcept :
   vertex_array_id(pipeline.vertex_array_id), shader(pipeline.shader),
   pipeline_options(pipeline.pipeline_options),
-  buffer_meta_data(std::move(pipeline.buffer_meta_data)) {
+  program_pipeline(pipeline.program_pipeline),
+  buffer_meta_data(std::move(pipeline.buffer_meta_data)),
+  index_type(pipeline.index_type) {
   pipeline.vertex_array_id = 0;
 }
 
 Pipeline::~Pipeline() {
-  if (vertex_array_id) glDeleteVertexArrays(1, &vertex_array_id);
+  if (!vertex_array_id) return;
+
+  glDeleteVertexArrays(1, &vertex_array_id);
+  RenderState::current().forget_vertex_array(vertex_array_id);
 }
 
 void Pipeline::bind() const {
-  glBindVertexArray(vertex_array_id);
-
-  auto options = pipeline_options;
-
-  glUseProgram(shader->id);
-  glEnable(GL_SCISSOR_TEST);
-
-  if (options.depth_write) {
-    glEnable(GL_DEPTH_TEST);
-    glDepthFunc(static_cast<GLenum>(options.depth_test));
-  } else {
-    glDisable(GL_DEPTH_TEST);
-  }
-
-  glFrontFace(static_cast<GLenum>(options.front_face_order));
-
-  switch (options.cull_face) {
-    case CullFace::Nothing: {
-      glDisable(GL_CULL_FACE);
-      break;
-    }
-
-    case CullFace::Front: {
-      glEnable(GL_CULL_FACE);
-      glCullFace(GL_FRONT);
-      break;
-    }
-
-    case CullFace::Back: {
-      glEnable(GL_CULL_FACE);
-      glCullFace(GL_BACK);
-      break;
-    }
-  }
+  auto &render_state = RenderState::current();
 
-  if (options.color_blend.has_value()) {
-    glEnable(GL_BLEND);
-
-    auto color_blend = options.color_blend.value();
-
-    if (options.alpha_blend.has_value()) {
-      auto alpha_blend = options.alpha_blend.value();
-
-      glBlendFuncSeparate(
-        static_cast<GLenum>(color_blend.source_factor),
-        static_cast<GLenum>(color_blend.destination_factor),
-        static_cast<GLenum>(alpha_blend.source_factor),
-        static_cast<GLenum>(alpha_blend.destination_factor)
-      );
-
-      glBlendEquationSeparate(
-        static_cast<GLenum>(color_blend.equation),
-        static_cast<GLenum>(alpha_blend.equation)
-      );
-    } else {
-      glBlendFunc(
-        static_cast<GLenum>(color_blend.source_factor),
-        static_cast<GLenum>(color_blend.destination_factor)
-      );
-      glBlendEquationSeparate(
-        static_cast<GLenum>(color_blend.equation),
-        static_cast<GLenum>(color_blend.equation)
-      );
-    }
+  render_state.bind_vertex_array(vertex_array_id);
+  if (program_pipeline) {
+    program_pipeline->bind();
   } else {
-    glDisable(GL_BLEND);
+    render_state.use_program(shader->id);
   }
-
-  if (options.stencil_test.has_value()) {
-    glEnable(GL_STENCIL_TEST);
-
-    auto stencil_test = options.stencil_test.value();
-
-    auto front = stencil_test.front_face;
-    glStencilOpSeparate(
-      GL_FRONT,
-      static_cast<GLenum>(front.fail_operation),
-      static_cast<GLenum>(front.depth_fail_operation),
-      static_cast<GLenum>(front.pass_operation)
-    );
-    glStencilFuncSeparate(
-      GL_FRONT,
-      static_cast<GLenum>(front.test_function),
-      front.test_reference,
-      front.test_mask
-    );
-    glStencilMaskSeparate(GL_FRONT, front.write_mask);
-
-    auto back = stencil_test.back_face;
-    glStencilOpSeparate(
-      GL_BACK,
-      static_cast<GLenum>(back.fail_operation),
-      static_cast<GLenum>(back.depth_fail_operation),
-      static_cast<GLenum>(back.pass_operation)
-    );
-    glStencilFuncSeparate(
-      GL_BACK,
-      static_cast<GLenum>(back.test_function),
-      back.test_reference,
-      back.test_mask
-    );
-    glStencilMaskSeparate(GL_BACK, back.write_mask);
-  } else {
-    glDisable(GL_STENCIL_TEST);
-  }
-
-  auto color_mask = options.color_mask;
-  glColorMask(color_mask[0], color_mask[1], color_mask[2], color_mask[3]);
+  render_state.apply(pipeline_options);
 }
 
 void Pipeline::bind_buffers(
@@ -379,18 +460,97 @@ void Pipeline::bind_buffers(
   }
 
   glVertexArrayElementBuffer(vertex_array_id, index_buffer.id);
+  index_type = index_buffer.index_type;
+}
+
+void Pipeline::bind_buffers(
+  std::initializer_list<BufferBinding> vertex_buffers,
+  const Buffer &index_buffer
+) const {
+  bind_vertex_buffers({vertex_buffers.begin(), vertex_buffers.size()});
+  bind_index_buffer(index_buffer.id, index_buffer.index_type);
 }
 
-void Pipeline::draw(uint32_t elements, uint32_t offset) const {
+void Pipeline::bind_buffers(
+  std::initializer_list<BufferBinding> vertex_buffers,
+  const BufferArena &index_arena
+) const {
+  bind_vertex_buffers({vertex_buffers.begin(), vertex_buffers.size()});
+  bind_index_buffer(index_arena.id, index_arena.index_type);
+}
+
+void Pipeline::bind_vertex_buffers(std::span<const BufferBinding> vertex_buffers
+) const {
+  for (auto const [index, vertex_buffer] :
+       std::views::enumerate(vertex_buffers)) {
+    glVertexArrayVertexBuffer(
+      vertex_array_id,
+      index,
+      vertex_buffer.id,
+      vertex_buffer.offset,
+      buffer_meta_data[index].stride
+    );
+  }
+}
+
+void Pipeline::bind_index_buffer(
+  uint32_t index_buffer_id, IndexType index_buffer_type
+) const {
+  glVertexArrayElementBuffer(vertex_array_id, index_buffer_id);
+  index_type = index_buffer_type;
+}
+
+void Pipeline::draw(uint32_t elements, uint32_t offset, int32_t base_vertex)
+  const {
   auto options = pipeline_options;
-  // TODO different index types?
-  auto index_type = GL_UNSIGNED_INT;
-  auto index_size = 4;
 
-  glDrawElements(
+  glDrawElementsBaseVertex(
     static_cast<GLenum>(options.primitive_type),
     elements,
-    index_type,
-    reinterpret_cast<void *>(offset * index_size)
+    static_cast<GLenum>(index_type),
+    reinterpret_cast<void *>(offset * index_size_of(index_type)),
+    base_vertex
   );
 }
+
+void Pipeline::draw_instanced(
+  uint32_t elements,
+  uint32_t instance_count,
+  uint32_t base_instance,
+  uint32_t offset,
+  int32_t base_vertex
+) const {
+  auto options = pipeline_options;
+
+  glDrawElementsInstancedBaseVertexBaseInstance(
+    static_cast<GLenum>(options.primitive_type),
+    elements,
+    static_cast<GLenum>(index_type),
+    reinterpret_cast<void *>(offset * index_size_of(index_type)),
+    instance_count,
+    base_vertex,
+    base_instance
+  );
+}
+
+void Pipeline::multi_draw_indirect(
+  const DrawIndirectBuffer &commands,
+  uint32_t draw_count,
+  uint32_t first_command
+) const {
+  auto options = pipeline_options;
+  auto command_size = sizeof(DrawElementsIndirectCommand);
+
+  commands.buffer.bind();
+  glMultiDrawElementsIndirect(
+    static_cast<GLenum>(options.primitive_type),
+    static_cast<GLenum>(index_type),
+    reinterpret_cast<void *>(first_command * command_size),
+    draw_count,
+    command_size
+  );
+}
+
+void Pipeline::multi_draw_indirect(const DrawIndirectBuffer &commands) const {
+  multi_draw_indirect(commands, commands.command_count);
+}
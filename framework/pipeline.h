@@ -1,6 +1,9 @@
 #pragma once
 
 #include "framework/buffer.h"
+#include "framework/buffer_arena.h"
+#include "framework/program_pipeline.h"
+#include "framework/vertex_layout.h"
 #include <GL/glew.h>
 #include <framework/shader.h>
 #include <array>
@@ -87,6 +90,8 @@ namespace framework {
     int32_t test_reference;
     uint32_t test_mask;
     uint32_t write_mask;
+
+    bool operator==(const StencilFaceState &) const = default;
   };
 
   struct StencilState {
@@ -118,37 +123,12 @@ namespace framework {
     uint32_t offset;
   };
 
-  enum class VertexFormat {
-    Float1,
-    Float2,
-    Float3,
-    Float4,
-    Byte1,
-    Byte2,
-    Byte3,
-    Byte4,
-    Short1,
-    Short2,
-    Short3,
-    Short4,
-    Int1,
-    Int2,
-    Int3,
-    Int4,
-    Mat4,
-  };
-
   struct VertexAttribute {
     std::string name;
     VertexFormat format;
     uint32_t buffer_index = 0;
   };
 
-  enum class VertexStep {
-    PerVertex,
-    PerInstance,
-  };
-
   struct BufferLayout {
     std::optional<uint32_t> stride = std::nullopt;
     VertexStep step = VertexStep::PerVertex;
@@ -159,6 +139,7 @@ namespace framework {
     uint32_t attribute_location;
     uint32_t size;
     uint32_t type;
+    bool normalized;
     uint32_t offset;
     uint32_t stride;
     uint32_t buffer_index;
@@ -169,8 +150,14 @@ namespace framework {
     uint32_t vertex_array_id = 0;
     std::shared_ptr<Shader> shader;
     PipelineOptions pipeline_options;
+
+    // Used instead of `shader` when set, `shader` is then its vertex stage
+    std::shared_ptr<ProgramPipeline> program_pipeline;
     std::vector<BufferMetaData> buffer_meta_data;
 
+    // Type of the bound index buffer, set by `bind_buffers`
+    mutable IndexType index_type = IndexType::UnsignedInt;
+
     inline static std::array<BufferLayout, 1> DEFAULT_BUFFER_LAYOUT = {{}};
 
     Pipeline(
@@ -180,6 +167,27 @@ namespace framework {
       std::span<BufferLayout> buffer_layouts = std::span(DEFAULT_BUFFER_LAYOUT)
     );
 
+    Pipeline(
+      std::shared_ptr<ProgramPipeline> program_pipeline,
+      std::initializer_list<VertexAttribute> vertex_attributes,
+      PipelineOptions pipeline_options = {},
+      std::span<BufferLayout> buffer_layouts = std::span(DEFAULT_BUFFER_LAYOUT)
+    );
+
+    /// Attributes at the explicit locations of `vertex_layout_of` layouts,
+    /// one per vertex buffer
+    Pipeline(
+      std::shared_ptr<Shader> shader,
+      std::initializer_list<VertexBufferLayout> vertex_buffers,
+      PipelineOptions pipeline_options = {}
+    );
+
+    Pipeline(
+      std::shared_ptr<ProgramPipeline> program_pipeline,
+      std::initializer_list<VertexBufferLayout> vertex_buffers,
+      PipelineOptions pipeline_options = {}
+    );
+
     Pipeline(Pipeline &&pipeline) noexcept;
 
     ~Pipeline();
@@ -191,6 +199,50 @@ namespace framework {
       const Buffer &index_buffer
     ) const;
 
-    void draw(uint32_t elements, uint32_t offset = 0) const;
+    void bind_buffers(
+      std::initializer_list<BufferBinding> vertex_buffers,
+      const Buffer &index_buffer
+    ) const;
+
+    void bind_buffers(
+      std::initializer_list<BufferBinding> vertex_buffers,
+      const BufferArena &index_arena
+    ) const;
+
+    void bind_vertex_buffers(std::span<const BufferBinding> vertex_buffers
+    ) const;
+
+    void bind_index_buffer(
+      uint32_t index_buffer_id, IndexType index_buffer_type
+    ) const;
+
+    /// `offset` is in indices, `base_vertex` is added to every index
+    void draw(uint32_t elements, uint32_t offset = 0, int32_t base_vertex = 0)
+      const;
+
+    /// Draws `instance_count` instances, per instance attributes start at
+    /// instance `base_instance`
+    void draw_instanced(
+      uint32_t elements,
+      uint32_t instance_count,
+      uint32_t base_instance = 0,
+      uint32_t offset = 0,
+      int32_t base_vertex = 0
+    ) const;
+
+    /// Draws `draw_count` commands starting at `first_command`, in a single
+    /// call
+    void multi_draw_indirect(
+      const DrawIndirectBuffer &commands,
+      uint32_t draw_count,
+      uint32_t first_command = 0
+    ) const;
+
+    void multi_draw_indirect(const DrawIndirectBuffer &commands) const;
+
+  private:
+    void create_vertex_array(
+      std::span<const VertexAttributeLayout> vertex_layout
+    );
   };
 }
@@ -0,0 +1,83 @@
+#include "program_pipeline.h"
+#include "render_state.h"
+#include <format>
+#include <stdexcept>
+
+using namespace framework;
+
+static GLbitfield stage_bit_of(ShaderType type) {
+  switch (type) {
+    case ShaderType::Vertex:
+      return GL_VERTEX_SHADER_BIT;
+    case ShaderType::Fragment:
+      return GL_FRAGMENT_SHADER_BIT;
+    case ShaderType::Compute:
+      return GL_COMPUTE_SHADER_BIT;
+  }
+
+  return 0;
+}
+
+ProgramPipeline::ProgramPipeline(
+  std::initializer_list<std::shared_ptr<Shader>> stages
+) :
+  stages(stages) {
+  for (auto &stage : stages) {
+    if (!stage->options.separable) {
+      throw std::runtime_error(std::format(
+        "Shader {} is not separable.", stage->stage_files.front().path.string()
+      ));
+    }
+  }
+
+  glCreateProgramPipelines(1, &id);
+  attach_stages();
+}
+
+ProgramPipeline::ProgramPipeline(ProgramPipeline &&program_pipeline) noexcept :
+  id(program_pipeline.id), stages(std::move(program_pipeline.stages)),
+  attached_program_ids(std::move(program_pipeline.attached_program_ids)) {
+  program_pipeline.id = 0;
+}
+
+ProgramPipeline::~ProgramPipeline() {
+  if (!id) return;
+
+  glDeleteProgramPipelines(1, &id);
+  RenderState::current().forget_program_pipeline(id);
+}
+
+std::shared_ptr<Shader> ProgramPipeline::stage(ShaderType type) const {
+  for (auto &stage : stages) {
+    for (auto &stage_file : stage->stage_files) {
+      if (stage_file.type == type) return stage;
+    }
+  }
+
+  return nullptr;
+}
+
+void ProgramPipeline::attach_stages() const {
+  attached_program_ids.clear();
+
+  for (auto &stage : stages) {
+    GLbitfield stage_bits = 0;
+    for (auto &stage_file : stage->stage_files) {
+      stage_bits |= stage_bit_of(stage_file.type);
+    }
+
+    glUseProgramStages(id, stage_bits, stage->id);
+    attached_program_ids.push_back(stage->id);
+  }
+}
+
+void ProgramPipeline::bind() const {
+  for (uint32_t i = 0; i < stages.size(); i++) {
+    if (stages[i]->id != attached_program_ids[i]) {
+      attach_stages();
+      break;
+    }
+  }
+
+  RenderState::current().use_program_pipeline(id);
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include "framework/shader.h"
+#include <GL/glew.h>
+#include <cstdint>
+#include <initializer_list>
+#include <memory>
+#include <vector>
+
+namespace framework {
+  /// Combines separable stage programs without linking them together, so a
+  /// vertex stage compiled once can be reused with many fragment stages
+  struct ProgramPipeline {
+    uint32_t id = 0;
+    std::vector<std::shared_ptr<Shader>> stages;
+
+    // Program ids last attached to the pipeline, they change when a stage
+    // is reloaded
+    mutable std::vector<uint32_t> attached_program_ids;
+
+    /// Every stage must be created with `ShaderOptions::separable`
+    ProgramPipeline(std::initializer_list<std::shared_ptr<Shader>> stages);
+
+    ProgramPipeline(ProgramPipeline &&program_pipeline) noexcept;
+
+    ~ProgramPipeline();
+
+    /// The stage program providing `type`, or nullptr
+    std::shared_ptr<Shader> stage(ShaderType type) const;
+
+    void bind() const;
+
+  private:
+    void attach_stages() const;
+  };
+}
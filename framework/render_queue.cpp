@@ -0,0 +1,156 @@
+#include "render_queue.h"
+#include <algorithm>
+#include <array>
+#include <limits>
+
+using namespace framework;
+
+// Bit widths of the sort key fields
+const uint32_t DEPTH_BITS = 24;
+const uint32_t STATE_BITS = 16;
+
+static uint64_t quantize_depth(float depth) {
+  const auto max_depth = (1u << DEPTH_BITS) - 1;
+
+  return static_cast<uint64_t>(std::clamp(depth, 0.0f, 1.0f) * max_depth);
+}
+
+/// LSD radix sort on the keys, one byte per pass. Passes where every key has
+/// the same byte are skipped.
+static void radix_sort(std::vector<std::pair<uint64_t, uint32_t>> &keys) {
+  std::vector<std::pair<uint64_t, uint32_t>> scratch(keys.size());
+
+  for (uint32_t shift = 0; shift < 64; shift += 8) {
+    std::array<uint32_t, 256> counts{};
+    for (auto [key, index] : keys) counts[(key >> shift) & 0xff]++;
+
+    auto first_byte = (keys.front().first >> shift) & 0xff;
+    if (counts[first_byte] == keys.size()) continue;
+
+    uint32_t total = 0;
+    for (auto &count : counts) {
+      auto bucket_size = count;
+      count = total;
+      total += bucket_size;
+    }
+
+    for (auto entry : keys) {
+      scratch[counts[(entry.first >> shift) & 0xff]++] = entry;
+    }
+
+    std::swap(keys, scratch);
+  }
+}
+
+uint16_t RenderQueue::state_id(
+  std::unordered_map<const void *, uint16_t> &ids,
+  const void *state,
+  uint16_t first_id
+) {
+  const size_t max_id = std::numeric_limits<uint16_t>::max();
+  auto id = std::min(first_id + ids.size(), max_id);
+  auto [entry, inserted] = ids.try_emplace(state, id);
+
+  return entry->second;
+}
+
+uint64_t RenderQueue::sort_key(const DrawPacket &packet) {
+  uint64_t pipeline = state_id(pipeline_ids, packet.pipeline, 0);
+
+  // Draws without textures get 0
+  uint64_t texture = packet.textures.empty()
+    ? 0
+    : state_id(texture_ids, packet.textures.front(), 1);
+  auto depth = quantize_depth(packet.depth);
+
+  if (packet.transparent) {
+    // Back to front, state only breaks ties
+    auto inverted_depth = ((1ull << DEPTH_BITS) - 1) - depth;
+
+    return (1ull << 63) | (inverted_depth << (63 - DEPTH_BITS)) |
+      (pipeline << (63 - DEPTH_BITS - STATE_BITS)) |
+      (texture << (63 - DEPTH_BITS - STATE_BITS * 2));
+  }
+
+  // Grouped by state to minimize changes, front to back within a group
+  return (pipeline << (63 - STATE_BITS)) |
+    (texture << (63 - STATE_BITS * 2)) |
+    (depth << (63 - STATE_BITS * 2 - DEPTH_BITS));
+}
+
+void RenderQueue::push(DrawPacket packet) {
+  sort_keys.emplace_back(sort_key(packet), packets.size());
+  packets.push_back(std::move(packet));
+}
+
+void RenderQueue::submit() {
+  stats = {};
+
+  if (!packets.empty()) radix_sort(sort_keys);
+
+  const Pipeline *bound_pipeline = nullptr;
+  const DrawPacket *bound_buffers = nullptr;
+  std::vector<const Texture *> bound_textures;
+
+  for (auto [key, index] : sort_keys) {
+    auto &packet = packets[index];
+
+    if (packet.pipeline != bound_pipeline) {
+      packet.pipeline->bind();
+      bound_pipeline = packet.pipeline;
+      bound_buffers = nullptr;
+      stats.pipeline_binds++;
+    }
+
+    // Buffer bindings live in the pipeline's vertex array
+    auto same_buffers = bound_buffers &&
+      bound_buffers->vertex_buffers.size() == packet.vertex_buffers.size() &&
+      std::ranges::equal(
+        bound_buffers->vertex_buffers,
+        packet.vertex_buffers,
+        [](auto a, auto b) { return a.id == b.id && a.offset == b.offset; }
+      ) &&
+      bound_buffers->index_buffer_id == packet.index_buffer_id;
+
+    if (!same_buffers) {
+      packet.pipeline->bind_vertex_buffers(packet.vertex_buffers);
+      packet.pipeline->bind_index_buffer(
+        packet.index_buffer_id, packet.index_type
+      );
+      bound_buffers = &packet;
+      stats.buffer_binds++;
+    }
+
+    if (bound_textures.size() < packet.textures.size()) {
+      bound_textures.resize(packet.textures.size(), nullptr);
+    }
+
+    for (uint32_t unit = 0; unit < packet.textures.size(); unit++) {
+      if (bound_textures[unit] == packet.textures[unit]) continue;
+
+      packet.textures[unit]->bind(unit);
+      bound_textures[unit] = packet.textures[unit];
+      stats.texture_binds++;
+    }
+
+    if (packet.uniforms) packet.uniforms();
+
+    if (packet.instance_count == 1 && packet.base_instance == 0) {
+      packet.pipeline->draw(packet.elements, packet.offset, packet.base_vertex);
+    } else {
+      packet.pipeline->draw_instanced(
+        packet.elements,
+        packet.instance_count,
+        packet.base_instance,
+        packet.offset,
+        packet.base_vertex
+      );
+    }
+    stats.draws++;
+  }
+
+  packets.clear();
+  sort_keys.clear();
+  pipeline_ids.clear();
+  texture_ids.clear();
+}
@@ -0,0 +1,73 @@
+#pragma once
+
+#include "framework/buffer.h"
+#include "framework/pipeline.h"
+#include "framework/texture.h"
+#include <cstdint>
+#include <functional>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace framework {
+  struct DrawPacket {
+    const Pipeline *pipeline;
+    std::vector<BufferBinding> vertex_buffers;
+    uint32_t index_buffer_id;
+    IndexType index_type = IndexType::UnsignedInt;
+
+    // Bound to texture units in order
+    std::vector<const Texture *> textures;
+
+    // Uploads the uniforms of this draw, called right before drawing
+    std::function<void()> uniforms;
+
+    uint32_t elements;
+    uint32_t offset = 0;
+    int32_t base_vertex = 0;
+    uint32_t instance_count = 1;
+    uint32_t base_instance = 0;
+
+    // View depth normalized to [0, 1], used to order the draws
+    float depth = 0.0f;
+    bool transparent = false;
+  };
+
+  struct RenderQueueStats {
+    uint32_t draws = 0;
+    uint32_t pipeline_binds = 0;
+    uint32_t buffer_binds = 0;
+    uint32_t texture_binds = 0;
+  };
+
+  /// Collects draws for a frame and submits them sorted by a 64-bit key:
+  /// opaque draws grouped by pipeline and textures then front to back,
+  /// transparent draws back to front after all opaque ones.
+  struct RenderQueue {
+    std::vector<DrawPacket> packets;
+    std::vector<std::pair<uint64_t, uint32_t>> sort_keys;
+
+    // Small per frame ids packed into the keys, pipelines and textures are
+    // numbered separately. Past 65535 distinct objects of one kind, the
+    // rest share the last id, which only costs some grouping.
+    std::unordered_map<const void *, uint16_t> pipeline_ids;
+    std::unordered_map<const void *, uint16_t> texture_ids;
+
+    RenderQueueStats stats;
+
+    void push(DrawPacket packet);
+
+    /// Sorts and draws all pushed packets, then clears the queue
+    void submit();
+
+  private:
+    uint64_t sort_key(const DrawPacket &packet);
+
+    /// Ids start at `first_id`, lower ones are left for missing state
+    static uint16_t state_id(
+      std::unordered_map<const void *, uint16_t> &ids,
+      const void *state,
+      uint16_t first_id
+    );
+  };
+}
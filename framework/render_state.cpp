@@ -0,0 +1,148 @@
+#include "render_state.h"
+
+using namespace framework;
+
+RenderState &RenderState::current() {
+  // The framework only ever has one context
+  static RenderState render_state;
+
+  return render_state;
+}
+
+void RenderState::use_program(uint32_t program_id) {
+  set(program, program_id, 1, [&] { glUseProgram(program_id); });
+}
+
+void RenderState::use_program_pipeline(uint32_t program_pipeline_id) {
+  use_program(0);
+
+  set(program_pipeline, program_pipeline_id, 1, [&] {
+    glBindProgramPipeline(program_pipeline_id);
+  });
+}
+
+void RenderState::bind_vertex_array(uint32_t vertex_array_id) {
+  set(vertex_array, vertex_array_id, 1, [&] {
+    glBindVertexArray(vertex_array_id);
+  });
+}
+
+void RenderState::set_enabled(
+  std::optional<bool> &cached, GLenum capability, bool value
+) {
+  set(cached, value, 1, [&] {
+    if (value) {
+      glEnable(capability);
+    } else {
+      glDisable(capability);
+    }
+  });
+}
+
+void RenderState::set_stencil_face(
+  std::optional<StencilFaceState> &cached,
+  GLenum face,
+  const StencilFaceState &value
+) {
+  set(cached, value, 3, [&] {
+    glStencilOpSeparate(
+      face,
+      static_cast<GLenum>(value.fail_operation),
+      static_cast<GLenum>(value.depth_fail_operation),
+      static_cast<GLenum>(value.pass_operation)
+    );
+    glStencilFuncSeparate(
+      face,
+      static_cast<GLenum>(value.test_function),
+      value.test_reference,
+      value.test_mask
+    );
+    glStencilMaskSeparate(face, value.write_mask);
+  });
+}
+
+void RenderState::apply(const PipelineOptions &options) {
+  set_enabled(scissor_test, GL_SCISSOR_TEST, true);
+
+  set_enabled(depth_test, GL_DEPTH_TEST, options.depth_write);
+  if (options.depth_write) {
+    auto function = static_cast<GLenum>(options.depth_test);
+    set(depth_function, function, 1, [&] { glDepthFunc(function); });
+  }
+
+  auto front_face_order = static_cast<GLenum>(options.front_face_order);
+  set(front_face, front_face_order, 1, [&] { glFrontFace(front_face_order); });
+
+  set_enabled(cull_face, GL_CULL_FACE, options.cull_face != CullFace::Nothing);
+  if (options.cull_face != CullFace::Nothing) {
+    auto mode = static_cast<GLenum>(options.cull_face);
+    set(cull_face_mode, mode, 1, [&] { glCullFace(mode); });
+  }
+
+  set_enabled(blend, GL_BLEND, options.color_blend.has_value());
+  if (options.color_blend.has_value()) {
+    auto color_blend = options.color_blend.value();
+    auto alpha_blend = options.alpha_blend.value_or(color_blend);
+
+    auto function = std::array{
+      static_cast<GLenum>(color_blend.source_factor),
+      static_cast<GLenum>(color_blend.destination_factor),
+      static_cast<GLenum>(alpha_blend.source_factor),
+      static_cast<GLenum>(alpha_blend.destination_factor),
+    };
+    set(blend_function, function, 1, [&] {
+      glBlendFuncSeparate(function[0], function[1], function[2], function[3]);
+    });
+
+    auto equation = std::array{
+      static_cast<GLenum>(color_blend.equation),
+      static_cast<GLenum>(alpha_blend.equation),
+    };
+    set(blend_equation, equation, 1, [&] {
+      glBlendEquationSeparate(equation[0], equation[1]);
+    });
+  }
+
+  set_enabled(stencil_test, GL_STENCIL_TEST, options.stencil_test.has_value());
+  if (options.stencil_test.has_value()) {
+    auto stencil_test = options.stencil_test.value();
+
+    set_stencil_face(stencil_front, GL_FRONT, stencil_test.front_face);
+    set_stencil_face(stencil_back, GL_BACK, stencil_test.back_face);
+  }
+
+  set(color_mask, options.color_mask, 1, [&] {
+    auto mask = options.color_mask;
+    glColorMask(mask[0], mask[1], mask[2], mask[3]);
+  });
+}
+
+void RenderState::invalidate() {
+  auto frame_stats = stats;
+  auto previous_frame_stats = last_frame_stats;
+  auto current_frame = frame;
+
+  *this = {};
+  stats = frame_stats;
+  last_frame_stats = previous_frame_stats;
+  frame = current_frame;
+}
+
+void RenderState::forget_program(uint32_t program_id) {
+  if (program == program_id) program.reset();
+}
+
+void RenderState::forget_program_pipeline(uint32_t program_pipeline_id) {
+  if (program_pipeline == program_pipeline_id) program_pipeline.reset();
+}
+
+void RenderState::forget_vertex_array(uint32_t vertex_array_id) {
+  // Deleting the bound vertex array binds 0 instead
+  if (vertex_array == vertex_array_id) vertex_array = 0;
+}
+
+void RenderState::end_frame() {
+  last_frame_stats = stats;
+  stats = {};
+  frame++;
+}
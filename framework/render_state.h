@@ -0,0 +1,96 @@
+#pragma once
+
+#include "framework/pipeline.h"
+#include <GL/glew.h>
+#include <array>
+#include <cstdint>
+#include <optional>
+
+namespace framework {
+  struct RenderStats {
+    uint32_t state_calls_issued = 0;
+    uint32_t state_calls_skipped = 0;
+    uint32_t uniform_uploads = 0;
+    uint32_t uniform_uploads_skipped = 0;
+  };
+
+  /// Shadow copy of the GL state set by pipelines, so only the calls that
+  /// actually change something are issued. Unknown state is `std::nullopt`.
+  struct RenderState {
+    std::optional<uint32_t> program;
+    std::optional<uint32_t> program_pipeline;
+    std::optional<uint32_t> vertex_array;
+    std::optional<bool> scissor_test;
+    std::optional<bool> depth_test;
+    std::optional<GLenum> depth_function;
+    std::optional<GLenum> front_face;
+    std::optional<bool> cull_face;
+    std::optional<GLenum> cull_face_mode;
+    std::optional<bool> blend;
+    std::optional<std::array<GLenum, 4>> blend_function;
+    std::optional<std::array<GLenum, 2>> blend_equation;
+    std::optional<bool> stencil_test;
+    std::optional<StencilFaceState> stencil_front;
+    std::optional<StencilFaceState> stencil_back;
+    std::optional<std::array<bool, 4>> color_mask;
+
+    // Counters of the current frame, and of the last finished one
+    RenderStats stats;
+    RenderStats last_frame_stats;
+
+    // Frames finished with `end_frame`
+    uint64_t frame = 0;
+
+    /// State tracker of the current context
+    static RenderState &current();
+
+    void use_program(uint32_t program_id);
+
+    /// Only takes effect while no program is in use, so this also unbinds
+    /// the current program
+    void use_program_pipeline(uint32_t program_pipeline_id);
+
+    void bind_vertex_array(uint32_t vertex_array_id);
+
+    void apply(const PipelineOptions &options);
+
+    /// Forgets all tracked state, call after changing GL state directly
+    void invalidate();
+
+    /// Stops tracking an object that is being deleted, since GL reuses
+    /// the names of deleted objects
+    void forget_program(uint32_t program_id);
+
+    void forget_program_pipeline(uint32_t program_pipeline_id);
+
+    void forget_vertex_array(uint32_t vertex_array_id);
+
+    /// Starts counting the next frame, call once after each frame
+    void end_frame();
+
+  private:
+    template <typename T, typename Apply>
+    void set(
+      std::optional<T> &cached, const T &value, uint32_t calls, Apply apply
+    ) {
+      if (cached == value) {
+        stats.state_calls_skipped += calls;
+        return;
+      }
+
+      apply();
+      cached = value;
+      stats.state_calls_issued += calls;
+    }
+
+    void set_enabled(
+      std::optional<bool> &cached, GLenum capability, bool value
+    );
+
+    void set_stencil_face(
+      std::optional<StencilFaceState> &cached,
+      GLenum face,
+      const StencilFaceState &value
+    );
+  };
+}
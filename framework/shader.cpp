@@ -1,22 +1,25 @@
 #include "shader.h"
+#include "internal.h"
+#include "render_state.h"
+#include "shader_preprocessor.h"
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <chrono>
+#include <cstring>
 #include <filesystem>
+#include <format>
 #include <fstream>
 #include <iostream>
 #include <optional>
+#include <stdexcept>
 #include <string>
+#include <vector>
 
 using namespace framework;
+using internal::hash_bytes;
 
-std::string read_file_to_string(const std::filesystem::path path) {
-  std::ifstream file(path);
-  std::string content(
-    (std::istreambuf_iterator<char>(file)), (std::istreambuf_iterator<char>())
-  );
-
-  return content;
-}
-
-std::optional<uint32_t> compile_shader(
+static uint32_t start_compile(
   const std::string &source, ShaderType shaderType
 ) {
   auto shader_id = glCreateShader(static_cast<GLenum>(shaderType));
@@ -25,6 +28,10 @@ std::optional<uint32_t> compile_shader(
   glShaderSource(shader_id, 1, &raw_source, nullptr);
   glCompileShader(shader_id);
 
+  return shader_id;
+}
+
+static bool compile_succeeded(uint32_t shader_id) {
   int32_t shader_did_compile;
   glGetShaderiv(shader_id, GL_COMPILE_STATUS, &shader_did_compile);
 
@@ -39,93 +46,677 @@ std::optional<uint32_t> compile_shader(
 
     std::cerr << "Failed to compile shader!" << std::endl;
     std::cerr << errorMessage.get() << std::endl;
+  }
+
+  return shader_did_compile;
+}
+
+static bool link_succeeded(uint32_t program_id) {
+  int32_t program_did_link;
+  glGetProgramiv(program_id, GL_LINK_STATUS, &program_did_link);
+
+  return program_did_link;
+}
+
+/// Cache file for a program, keyed by its sources and the driver since
+/// binaries are only valid for the driver that created them
+static std::filesystem::path program_binary_path(
+  const std::filesystem::path &cache_directory,
+  const std::vector<std::string> &sources,
+  bool separable
+) {
+  uint64_t hash = 0xcbf29ce484222325;
+  if (separable) hash = hash_bytes("separable", hash);
 
-    glDeleteShader(shader_id);
+  for (auto &source : sources) {
+    hash = hash_bytes(source, hash);
+    hash = hash_bytes(std::string_view("\0", 1), hash);
+  }
 
-    return std::nullopt;
+  for (auto name : {GL_VENDOR, GL_RENDERER, GL_VERSION}) {
+    auto value = reinterpret_cast<const char *>(glGetString(name));
+    hash = hash_bytes(value ? value : "", hash);
   }
 
-  return shader_id;
-};
+  return cache_directory / std::format("{:016x}.bin", hash);
+}
 
-Shader::Shader(
+static bool load_program_binary(
+  uint32_t program_id, const std::filesystem::path &binary_path
+) {
+  std::ifstream file(binary_path, std::ios::binary);
+  if (!file) return false;
+
+  uint32_t format;
+  if (!file.read(reinterpret_cast<char *>(&format), sizeof(format))) {
+    return false;
+  }
+
+  std::vector<char> binary(
+    (std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>()
+  );
+
+  if (binary.empty()) return false;
+
+  glProgramBinary(program_id, format, binary.data(), binary.size());
+
+  // Drivers reject binaries after updates, the caller compiles instead
+  return link_succeeded(program_id);
+}
+
+static void save_program_binary(
+  uint32_t program_id, const std::filesystem::path &binary_path
+) {
+  int32_t binary_length;
+  glGetProgramiv(program_id, GL_PROGRAM_BINARY_LENGTH, &binary_length);
+  if (binary_length <= 0) return;
+
+  std::vector<char> binary(binary_length);
+  uint32_t format;
+  glGetProgramBinary(
+    program_id, binary_length, nullptr, &format, binary.data()
+  );
+
+  std::error_code error;
+  std::filesystem::create_directories(binary_path.parent_path(), error);
+
+  std::ofstream file(binary_path, std::ios::binary);
+  file.write(reinterpret_cast<const char *>(&format), sizeof(format));
+  file.write(binary.data(), binary.size());
+
+  if (!file) {
+    std::cerr << "Failed to write program binary " << binary_path << "\n";
+  }
+}
+
+static bool program_binaries_supported() {
+  int32_t format_count = 0;
+  glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &format_count);
+
+  return format_count > 0;
+}
+
+static bool parallel_compile_supported() {
+  return GLEW_KHR_parallel_shader_compile || GLEW_ARB_parallel_shader_compile;
+}
+
+ShaderBuild ShaderBuild::start(
+  std::vector<ShaderStageFile> stage_files, ShaderOptions options
+) {
+  ShaderBuild build;
+  build.start_time = std::chrono::steady_clock::now();
+  build.stage_files = stage_files;
+  build.options = options;
+  build.report_timing = options.binary_cache_directory.has_value();
+
+  for (auto &stage_file : stage_files) {
+    if (!build.label.empty()) build.label += " + ";
+    build.label += stage_file.path.filename().string();
+  }
+
+  build.program_id = glCreateProgram();
+
+  std::vector<std::string> sources;
+  for (auto &stage_file : stage_files) {
+    auto preprocessed = preprocess_shader(stage_file.path, options.defines);
+
+    sources.push_back(std::move(preprocessed.source));
+    build.source_files.insert(
+      build.source_files.end(),
+      preprocessed.files.begin(),
+      preprocessed.files.end()
+    );
+  }
+
+  if (options.binary_cache_directory.has_value() &&
+      program_binaries_supported()) {
+    build.binary_path =
+      program_binary_path(
+        options.binary_cache_directory.value(), sources, options.separable
+      );
+  }
+
+  // Has to be set before the binary is loaded or the program is linked
+  if (options.separable) {
+    glProgramParameteri(build.program_id, GL_PROGRAM_SEPARABLE, GL_TRUE);
+  }
+
+  build.loaded_from_cache = build.binary_path.has_value() &&
+    load_program_binary(build.program_id, build.binary_path.value());
+
+  if (build.loaded_from_cache) return build;
+
+  if (build.binary_path.has_value()) {
+    glProgramParameteri(
+      build.program_id, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE
+    );
+  }
+
+  // Compile statuses are only queried once the program is needed, so the
+  // driver can keep compiling in the background meanwhile
+  for (uint32_t i = 0; i < stage_files.size(); i++) {
+    auto stage_id = start_compile(sources[i], stage_files[i].type);
+
+    glAttachShader(build.program_id, stage_id);
+    build.stage_ids.push_back(stage_id);
+  }
+
+  glLinkProgram(build.program_id);
+
+  return build;
+}
+
+ShaderBuild ShaderBuild::start(
   std::filesystem::path vertex_shader_file,
-  std::filesystem::path fragment_shader_file
+  std::filesystem::path fragment_shader_file,
+  ShaderOptions options
 ) {
-  id = glCreateProgram();
+  return start(
+    {
+      {.type = ShaderType::Vertex, .path = vertex_shader_file},
+      {.type = ShaderType::Fragment, .path = fragment_shader_file},
+    },
+    options
+  );
+}
+
+ShaderBuild::ShaderBuild(ShaderBuild &&build) noexcept :
+  program_id(build.program_id), stage_ids(std::move(build.stage_ids)),
+  stage_files(std::move(build.stage_files)), options(build.options),
+  source_files(std::move(build.source_files)),
+  binary_path(std::move(build.binary_path)),
+  loaded_from_cache(build.loaded_from_cache),
+  report_timing(build.report_timing), label(std::move(build.label)),
+  start_time(build.start_time) {
+  build.program_id = 0;
+  build.stage_ids.clear();
+}
+
+ShaderBuild &ShaderBuild::operator=(ShaderBuild &&build) noexcept {
+  std::swap(program_id, build.program_id);
+  std::swap(stage_ids, build.stage_ids);
+  stage_files = std::move(build.stage_files);
+  options = build.options;
+  source_files = std::move(build.source_files);
+  binary_path = std::move(build.binary_path);
+  loaded_from_cache = build.loaded_from_cache;
+  report_timing = build.report_timing;
+  label = std::move(build.label);
+  start_time = build.start_time;
+
+  return *this;
+}
+
+ShaderBuild::~ShaderBuild() {
+  for (auto stage_id : stage_ids) glDeleteShader(stage_id);
+  if (program_id) glDeleteProgram(program_id);
+}
+
+bool ShaderBuild::is_complete() const {
+  if (!parallel_compile_supported()) return true;
+
+  int32_t completed;
+  glGetProgramiv(program_id, GL_COMPLETION_STATUS_KHR, &completed);
+
+  return completed;
+}
+
+Shader::Shader(
+  std::filesystem::path vertex_shader_file,
+  std::filesystem::path fragment_shader_file,
+  ShaderOptions options
+) :
+  Shader(ShaderBuild::start(vertex_shader_file, fragment_shader_file, options)
+  ) {}
+
+Shader::Shader(
+  std::filesystem::path compute_shader_file, ShaderOptions options
+) :
+  Shader(ShaderBuild::start(
+    {{.type = ShaderType::Compute, .path = compute_shader_file}}, options
+  )) {}
+
+static ShaderOptions separable_options(ShaderOptions options) {
+  options.separable = true;
+
+  return options;
+}
+
+Shader::Shader(
+  ShaderType type, std::filesystem::path shader_file, ShaderOptions options
+) :
+  Shader(ShaderBuild::start(
+    {{.type = type, .path = shader_file}}, separable_options(options)
+  )) {}
 
-  auto vertex_shader_source = read_file_to_string(vertex_shader_file);
-  auto fragment_shader_source = read_file_to_string(fragment_shader_file);
+Shader::Shader(ShaderBuild build) :
+  stage_files(build.stage_files), options(build.options),
+  source_files(build.source_files) {
+  id = finish_build(std::move(build));
+  reflect_uniforms();
+}
 
-  auto vertex_shader =
-    compile_shader(vertex_shader_source, ShaderType::Vertex).value();
-  auto fragment_shader =
-    compile_shader(fragment_shader_source, ShaderType::Fragment).value();
+uint32_t Shader::finish_build(ShaderBuild build) {
+  auto compiled = true;
+  for (auto stage_id : build.stage_ids) {
+    compiled = compile_succeeded(stage_id) && compiled;
+  }
 
-  glAttachShader(id, vertex_shader);
-  glAttachShader(id, fragment_shader);
+  if (!compiled) {
+    throw std::runtime_error("Failed to compile shader " + build.label);
+  }
 
-  glLinkProgram(id);
-  glValidateProgram(id);
+  if (!link_succeeded(build.program_id)) {
+    int32_t errorLength;
+    glGetProgramiv(build.program_id, GL_INFO_LOG_LENGTH, &errorLength);
+
+    auto errorMessage = std::make_unique<char[]>(errorLength + 1);
+    glGetProgramInfoLog(
+      build.program_id, errorLength + 1, nullptr, errorMessage.get()
+    );
 
-  glDeleteShader(vertex_shader);
-  glDeleteShader(fragment_shader);
-};
+    std::cerr << "Failed to link shader!" << std::endl;
+    std::cerr << errorMessage.get() << std::endl;
+
+    throw std::runtime_error("Failed to link shader " + build.label);
+  }
+
+  auto program_id = build.program_id;
+  build.program_id = 0;
+
+  if (!build.loaded_from_cache) glValidateProgram(program_id);
+
+  for (auto stage_id : build.stage_ids) {
+    glDetachShader(program_id, stage_id);
+    glDeleteShader(stage_id);
+  }
+  build.stage_ids.clear();
+
+  if (!build.loaded_from_cache && build.binary_path.has_value()) {
+    save_program_binary(program_id, build.binary_path.value());
+  }
+
+  if (build.report_timing) {
+    auto duration = std::chrono::duration<float, std::milli>(
+      std::chrono::steady_clock::now() - build.start_time
+    );
+
+    std::cout << "Shader " << build.label << ": "
+              << (build.loaded_from_cache ? "loaded from cache" : "compiled")
+              << " in " << duration.count() << " ms\n";
+  }
 
-Shader::Shader(Shader &&shader) noexcept : id(shader.id) {
+  return program_id;
+}
+
+bool Shader::reload(ShaderBuild build) {
+  uint32_t program_id;
+  auto build_source_files = build.source_files;
+
+  try {
+    program_id = finish_build(std::move(build));
+  } catch (const std::runtime_error &error) {
+    std::cerr << error.what() << ", keeping the previous program\n";
+    return false;
+  }
+
+  glDeleteProgram(id);
+  RenderState::current().forget_program(id);
+
+  id = program_id;
+  source_files = build_source_files;
+
+  reflect_uniforms();
+
+  for (auto &[name, binding] : uniform_block_bindings) {
+    auto block_index = glGetUniformBlockIndex(id, name.c_str());
+
+    if (block_index != GL_INVALID_INDEX) {
+      glUniformBlockBinding(id, block_index, binding);
+    }
+  }
+
+  return true;
+}
+
+Shader::Shader(Shader &&shader) noexcept :
+  id(shader.id), stage_files(std::move(shader.stage_files)),
+  options(shader.options), source_files(std::move(shader.source_files)),
+  uniforms(std::move(shader.uniforms)),
+  uniform_names(std::move(shader.uniform_names)),
+  uniform_table(std::move(shader.uniform_table)),
+  uniform_values(std::move(shader.uniform_values)),
+  uniform_value_known(std::move(shader.uniform_value_known)),
+  uniform_block_bindings(std::move(shader.uniform_block_bindings)) {
   shader.id = 0;
 }
 
 Shader::~Shader() {
-  if (id) glDeleteProgram(id);
+  if (!id) return;
+
+  glDeleteProgram(id);
+  RenderState::current().forget_program(id);
 }
 
 void Shader::bind() const {
-  glUseProgram(id);
+  RenderState::current().use_program(id);
+}
+
+static uint64_t hash_name(std::string_view name) {
+  return hash_bytes(name, 0xcbf29ce484222325);
+}
+
+/// Bytes taken by one element of a uniform, 0 for types that aren't cached
+static uint32_t bytes_of_uniform_type(GLenum type) {
+  switch (type) {
+    case GL_FLOAT:
+    case GL_INT:
+    case GL_UNSIGNED_INT:
+    case GL_BOOL:
+      return 4;
+    case GL_FLOAT_VEC2:
+    case GL_INT_VEC2:
+    case GL_UNSIGNED_INT_VEC2:
+    case GL_BOOL_VEC2:
+      return 8;
+    case GL_FLOAT_VEC3:
+    case GL_INT_VEC3:
+    case GL_UNSIGNED_INT_VEC3:
+    case GL_BOOL_VEC3:
+      return 12;
+    case GL_FLOAT_VEC4:
+    case GL_INT_VEC4:
+    case GL_UNSIGNED_INT_VEC4:
+    case GL_BOOL_VEC4:
+    case GL_FLOAT_MAT2:
+      return 16;
+    case GL_FLOAT_MAT3:
+      return 36;
+    case GL_FLOAT_MAT4:
+      return 64;
+    default:
+      return 0;
+  }
+}
+
+void Shader::reflect_uniforms() {
+  // Uniforms known from a previous program keep their index, so handles
+  // stay valid across reloads. Ones that disappeared keep an inactive slot.
+  auto previous_uniforms = std::move(uniforms);
+
+  uniforms.clear();
+  for (auto &previous_uniform : previous_uniforms) {
+    uniforms.push_back({
+      .name = previous_uniform.name,
+      .location = -1,
+      .type = 0,
+      .array_size = 0,
+      .value_offset = 0,
+      .value_size = 0,
+    });
+  }
+
+  uint32_t values_size = 0;
+
+  // Base names of arrays and the name of their first element
+  std::vector<std::pair<std::string, std::string>> array_aliases;
+
+  int32_t uniform_count;
+  glGetProgramInterfaceiv(id, GL_UNIFORM, GL_ACTIVE_RESOURCES, &uniform_count);
+
+  for (int32_t i = 0; i < uniform_count; i++) {
+    const std::array<GLenum, 4> properties = {
+      GL_NAME_LENGTH, GL_TYPE, GL_LOCATION, GL_ARRAY_SIZE
+    };
+    std::array<int32_t, 4> values;
+
+    glGetProgramResourceiv(
+      id,
+      GL_UNIFORM,
+      i,
+      properties.size(),
+      properties.data(),
+      values.size(),
+      nullptr,
+      values.data()
+    );
+
+    auto [name_length, type, location, array_size] = values;
+
+    // Members of uniform blocks have no location
+    if (location == -1) continue;
+
+    std::string name(name_length, '\0');
+    glGetProgramResourceName(
+      id, GL_UNIFORM, i, name_length, nullptr, name.data()
+    );
+    name.resize(name_length - 1);
+
+    // Arrays are reported as "name[0]", every element gets an entry of its
+    // own at consecutive locations, and "name" refers to the first one
+    auto is_array = name.ends_with("[0]");
+    auto base_name = name;
+    if (is_array) base_name.resize(name.size() - 3);
+
+    auto element_size = bytes_of_uniform_type(type);
+
+    for (int32_t element = 0; element < array_size; element++) {
+      auto element_name = name;
+      if (is_array) element_name = std::format("{}[{}]", base_name, element);
+
+      auto uniform_info = UniformInfo{
+        .name = element_name,
+        .location = location + element,
+        .type = static_cast<uint32_t>(type),
+        .array_size = static_cast<uint32_t>(array_size - element),
+        .value_offset = values_size,
+        .value_size = element_size,
+      };
+
+      auto previous = std::ranges::find(
+        uniforms.begin(),
+        uniforms.begin() + previous_uniforms.size(),
+        element_name,
+        &UniformInfo::name
+      );
+
+      if (previous != uniforms.begin() + previous_uniforms.size()) {
+        *previous = uniform_info;
+      } else {
+        uniforms.push_back(uniform_info);
+      }
+
+      values_size += element_size;
+    }
+
+    if (is_array) array_aliases.push_back({base_name, name});
+  }
+
+  uniform_values.assign(values_size, std::byte{0});
+  uniform_value_known.assign(uniforms.size(), false);
+
+  // Aliases go first so lookups find them before an inactive uniform of
+  // the same name, left by a reload that turned it into an array
+  uniform_names.clear();
+  for (auto &[base_name, first_element_name] : array_aliases) {
+    auto first_element =
+      std::ranges::find(uniforms, first_element_name, &UniformInfo::name);
+
+    uniform_names.push_back(
+      {base_name, static_cast<uint32_t>(first_element - uniforms.begin())}
+    );
+  }
+
+  for (uint32_t index = 0; index < uniforms.size(); index++) {
+    uniform_names.push_back({uniforms[index].name, index});
+  }
+
+  // Keep the table at most half full so probe sequences stay short
+  size_t table_size = 1;
+  while (table_size < uniform_names.size() * 2) table_size *= 2;
+
+  uniform_table.assign(table_size, UniformHandle::NOT_FOUND);
+
+  for (uint32_t name_index = 0; name_index < uniform_names.size();
+       name_index++) {
+    auto slot = hash_name(uniform_names[name_index].first) & (table_size - 1);
+    while (uniform_table[slot] != UniformHandle::NOT_FOUND) {
+      slot = (slot + 1) & (table_size - 1);
+    }
+
+    uniform_table[slot] = name_index;
+  }
+}
+
+void Shader::bind_uniform_block(const std::string &name, uint32_t binding) {
+  auto block_index = glGetUniformBlockIndex(id, name.c_str());
+  assert(block_index != GL_INVALID_INDEX);
+
+  if (block_index != GL_INVALID_INDEX) {
+    glUniformBlockBinding(id, block_index, binding);
+  }
+
+  std::erase_if(uniform_block_bindings, [&](auto &block_binding) {
+    return block_binding.first == name;
+  });
+  uniform_block_bindings.emplace_back(name, binding);
+}
+
+UniformHandle Shader::uniform(std::string_view name) const {
+  if (uniforms.empty()) return {};
+
+  auto mask = uniform_table.size() - 1;
+  auto slot = hash_name(name) & mask;
+
+  while (uniform_table[slot] != UniformHandle::NOT_FOUND) {
+    auto &[uniform_name, index] = uniform_names[uniform_table[slot]];
+    if (uniform_name == name) return {.index = index};
+
+    slot = (slot + 1) & mask;
+  }
+
+  return {};
+}
+
+int32_t Shader::location_of(UniformHandle uniform) const {
+  if (!uniform.is_valid()) return -1;
+
+  return uniforms[uniform.index].location;
+}
+
+bool Shader::update_value(
+  UniformHandle uniform, const void *value, uint32_t size
+) const {
+  auto &stats = RenderState::current().stats;
+
+  if (!uniform.is_valid()) return false;
+
+  auto &info = uniforms[uniform.index];
+  if (info.location == -1) return false;
+
+  if (size > info.value_size) {
+    stats.uniform_uploads++;
+    return true;
+  }
+
+  auto cached = uniform_values.data() + info.value_offset;
+  if (uniform_value_known[uniform.index] &&
+      std::memcmp(cached, value, size) == 0) {
+    stats.uniform_uploads_skipped++;
+    return false;
+  }
+
+  std::memcpy(cached, value, size);
+  uniform_value_known[uniform.index] = true;
+  stats.uniform_uploads++;
+
+  return true;
+}
+
+UniformHandle Shader::checked_uniform(const std::string &name) const {
+  auto handle = uniform(name);
+  assert(handle.is_valid());
+
+  return handle;
+}
+
+void Shader::uploadUniformBool1(UniformHandle uniform, bool value) const {
+  int32_t int_value = value;
+  if (!update_value(uniform, &int_value, sizeof(int_value))) return;
+
+  glProgramUniform1i(id, location_of(uniform), int_value);
+}
+
+void Shader::uploadUniformInt1(UniformHandle uniform, int value) const {
+  if (!update_value(uniform, &value, sizeof(value))) return;
+
+  glProgramUniform1i(id, location_of(uniform), value);
+}
+
+void Shader::uploadUniformInt2(UniformHandle uniform, glm::ivec2 value)
+  const {
+  if (!update_value(uniform, &value, sizeof(value))) return;
+
+  glProgramUniform2i(id, location_of(uniform), value.x, value.y);
+}
+
+void Shader::uploadUniformFloat1(UniformHandle uniform, float value) const {
+  if (!update_value(uniform, &value, sizeof(value))) return;
+
+  glProgramUniform1f(id, location_of(uniform), value);
+}
+
+void Shader::uploadUniformFloat3(UniformHandle uniform, glm::vec3 value)
+  const {
+  if (!update_value(uniform, &value, sizeof(value))) return;
+
+  glProgramUniform3f(id, location_of(uniform), value.r, value.g, value.b);
+}
+
+void Shader::uploadUniformFloat4(UniformHandle uniform, glm::vec4 value)
+  const {
+  if (!update_value(uniform, &value, sizeof(value))) return;
+
+  glProgramUniform4f(
+    id, location_of(uniform), value.r, value.g, value.b, value.a
+  );
+}
+
+void Shader::uploadUniformMatrix4(UniformHandle uniform, glm::mat4 value)
+  const {
+  if (!update_value(uniform, &value, sizeof(value))) return;
+
+  glProgramUniformMatrix4fv(id, location_of(uniform), 1, false, &value[0][0]);
 }
 
 void Shader::uploadUniformBool1(const std::string &name, bool value) const {
-  int32_t location = glGetUniformLocation(id, name.c_str());
-  assert(location != -1);
-  glProgramUniform1i(id, location, value);
+  uploadUniformBool1(checked_uniform(name), value);
 }
 
 void Shader::uploadUniformInt1(const std::string &name, int value) const {
-  int32_t location = glGetUniformLocation(id, name.c_str());
-  assert(location != -1);
-  glProgramUniform1i(id, location, value);
+  uploadUniformInt1(checked_uniform(name), value);
 }
 
 void Shader::uploadUniformInt2(const std::string &name, glm::ivec2 value)
   const {
-  auto location = glGetUniformLocation(id, name.c_str());
-  assert(location != -1);
-  glProgramUniform2i(id, location, value.x, value.y);
+  uploadUniformInt2(checked_uniform(name), value);
 }
 
 void Shader::uploadUniformFloat1(const std::string &name, float value) const {
-  int32_t location = glGetUniformLocation(id, name.c_str());
-  assert(location != -1);
-  glProgramUniform1f(id, location, value);
+  uploadUniformFloat1(checked_uniform(name), value);
 }
 
 void Shader::uploadUniformFloat3(const std::string &name, glm::vec3 value)
   const {
-  int32_t location = glGetUniformLocation(id, name.c_str());
-  assert(location != -1);
-  glProgramUniform3f(id, location, value.r, value.g, value.b);
+  uploadUniformFloat3(checked_uniform(name), value);
 }
 
 void Shader::uploadUniformFloat4(const std::string &name, glm::vec4 value)
   const {
-  int32_t location = glGetUniformLocation(id, name.c_str());
-  assert(location != -1);
-  glProgramUniform4f(id, location, value.r, value.g, value.b, value.a);
+  uploadUniformFloat4(checked_uniform(name), value);
 }
 
 void Shader::uploadUniformMatrix4(const std::string &name, glm::mat4 value)
   const {
-  auto location = glGetUniformLocation(id, name.c_str());
-  assert(location != -1);
-  glProgramUniformMatrix4fv(id, location, 1, false, &value[0][0]);
+  uploadUniformMatrix4(checked_uniform(name), value);
 }
@@ -1,31 +1,191 @@
 #pragma once
 
+#include "framework/shader_preprocessor.h"
 #include <GL/glew.h>
 #include <glm/glm.hpp>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
 #include <filesystem>
+#include <limits>
+#include <optional>
 #include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
 
 namespace framework {
   enum class ShaderType {
     Vertex = GL_VERTEX_SHADER,
     Fragment = GL_FRAGMENT_SHADER,
+    Compute = GL_COMPUTE_SHADER,
+  };
+
+  /// Refers to a uniform of a `Shader`, look it up once and reuse it
+  struct UniformHandle {
+    static constexpr uint32_t NOT_FOUND = std::numeric_limits<uint32_t>::max();
+
+    uint32_t index = NOT_FOUND;
+
+    bool is_valid() const {
+      return index != NOT_FOUND;
+    }
+  };
+
+  struct UniformInfo {
+    std::string name;
+    int32_t location;
+    uint32_t type;
+
+    // Elements from this one to the end of its array, 1 for non arrays
+    uint32_t array_size;
+
+    // Bytes of the last uploaded value in `Shader::uniform_values`
+    uint32_t value_offset;
+    uint32_t value_size;
+  };
+
+  struct ShaderOptions {
+    // Linked program binaries are cached in this directory when set, keyed
+    // by the sources and the driver
+    std::optional<std::filesystem::path> binary_cache_directory = std::nullopt;
+
+    // Injected into every stage after its `#version` line
+    std::vector<ShaderDefine> defines = {};
+
+    // Linked with `GL_PROGRAM_SEPARABLE`, so a `ProgramPipeline` can combine
+    // it with programs of other stages
+    bool separable = false;
+  };
+
+  struct ShaderStageFile {
+    ShaderType type;
+    std::filesystem::path path;
+  };
+
+  /// A program whose compile and link were started, but whose status was not
+  /// checked yet. With parallel shader compilation the driver finishes it in
+  /// the background.
+  struct ShaderBuild {
+    uint32_t program_id = 0;
+    std::vector<uint32_t> stage_ids;
+    std::vector<ShaderStageFile> stage_files;
+    ShaderOptions options;
+    std::vector<std::filesystem::path> source_files;
+    std::optional<std::filesystem::path> binary_path;
+    bool loaded_from_cache = false;
+    bool report_timing = false;
+    std::string label;
+    std::chrono::steady_clock::time_point start_time;
+
+    static ShaderBuild start(
+      std::vector<ShaderStageFile> stage_files, ShaderOptions options = {}
+    );
+
+    static ShaderBuild start(
+      std::filesystem::path vertex_shader_file,
+      std::filesystem::path fragment_shader_file,
+      ShaderOptions options = {}
+    );
+
+    ShaderBuild() = default;
+
+    ShaderBuild(ShaderBuild &&build) noexcept;
+
+    ShaderBuild &operator=(ShaderBuild &&build) noexcept;
+
+    ~ShaderBuild();
+
+    ShaderBuild(const ShaderBuild &) = delete;
+
+    ShaderBuild &operator=(const ShaderBuild &) = delete;
+
+    /// Never blocks, always true if the driver can't tell
+    bool is_complete() const;
   };
 
-  // TODO: Shader hot reload?
   struct Shader {
     uint32_t id = 0;
 
+    // What the program was built from, to rebuild it on reload
+    std::vector<ShaderStageFile> stage_files;
+    ShaderOptions options;
+
+    // Stage files and everything they include
+    std::vector<std::filesystem::path> source_files;
+
+    // Active uniforms, found by reflection after linking
+    std::vector<UniformInfo> uniforms;
+
+    // Names uniforms can be looked up by, paired with their index in
+    // `uniforms`. Arrays are findable as "name", "name[0]" and "name[N]".
+    std::vector<std::pair<std::string, uint32_t>> uniform_names;
+
+    // Open addressing hash table of indices into `uniform_names`
+    std::vector<uint32_t> uniform_table;
+
+    // Shadow copy of the uploaded uniform values, used to skip uploads of
+    // values the program already has
+    mutable std::vector<std::byte> uniform_values;
+    mutable std::vector<bool> uniform_value_known;
+
+    // Uniform block name and binding point pairs assigned to this program
+    std::vector<std::pair<std::string, uint32_t>> uniform_block_bindings;
+
     Shader(
       std::filesystem::path vertex_shader_file,
-      std::filesystem::path fragment_shader_file
+      std::filesystem::path fragment_shader_file,
+      ShaderOptions options = {}
     );
 
+    /// Compute program with a single stage
+    explicit Shader(
+      std::filesystem::path compute_shader_file, ShaderOptions options = {}
+    );
+
+    /// Separable program of a single stage, for a `ProgramPipeline`
+    Shader(
+      ShaderType type,
+      std::filesystem::path shader_file,
+      ShaderOptions options = {}
+    );
+
+    /// Waits for `build` to finish and checks it
+    explicit Shader(ShaderBuild build);
+
     Shader(Shader &&shader) noexcept;
 
     ~Shader();
 
     void bind() const;
 
+    /// Swaps in the program of `build` if it compiles and links, otherwise
+    /// keeps the current program. Uniform handles and block bindings stay
+    /// valid, vertex attribute locations must not change.
+    bool reload(ShaderBuild build);
+
+    /// Makes the uniform block `name` read from the uniform buffer bound to
+    /// `binding`
+    void bind_uniform_block(const std::string &name, uint32_t binding);
+
+    /// Handle of the uniform called `name`, an invalid handle if the
+    /// uniform is not active. Uploads to invalid handles are ignored.
+    UniformHandle uniform(std::string_view name) const;
+
+    void uploadUniformBool1(UniformHandle uniform, bool value) const;
+
+    void uploadUniformInt1(UniformHandle uniform, int value) const;
+
+    void uploadUniformInt2(UniformHandle uniform, glm::ivec2 value) const;
+
+    void uploadUniformFloat1(UniformHandle uniform, float value) const;
+
+    void uploadUniformFloat3(UniformHandle uniform, glm::vec3 value) const;
+
+    void uploadUniformFloat4(UniformHandle uniform, glm::vec4 value) const;
+
+    void uploadUniformMatrix4(UniformHandle uniform, glm::mat4 value) const;
+
     void uploadUniformBool1(const std::string &name, bool value) const;
 
     void uploadUniformInt1(const std::string &name, int value) const;
@@ -39,5 +199,20 @@ namespace framework {
     void uploadUniformFloat4(const std::string &name, glm::vec4 value) const;
 
     void uploadUniformMatrix4(const std::string &name, glm::mat4 value) const;
+
+  private:
+    static uint32_t finish_build(ShaderBuild build);
+
+    void reflect_uniforms();
+
+    int32_t location_of(UniformHandle uniform) const;
+
+    /// Stores `value` in the shadow copy, returns false if the program
+    /// already has it and the upload can be skipped
+    bool update_value(
+      UniformHandle uniform, const void *value, uint32_t size
+    ) const;
+
+    UniformHandle checked_uniform(const std::string &name) const;
   };
 }
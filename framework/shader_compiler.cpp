@@ -0,0 +1,50 @@
+#include "shader_compiler.h"
+
+using namespace framework;
+
+ShaderCompiler::ShaderCompiler() {
+  // Let the driver pick how many threads to compile with
+  if (GLEW_KHR_parallel_shader_compile) {
+    glMaxShaderCompilerThreadsKHR(0xffffffff);
+  } else if (GLEW_ARB_parallel_shader_compile) {
+    glMaxShaderCompilerThreadsARB(0xffffffff);
+  }
+}
+
+uint32_t ShaderCompiler::add(
+  std::filesystem::path vertex_shader_file,
+  std::filesystem::path fragment_shader_file,
+  ShaderOptions options
+) {
+  entries.push_back({
+    .build =
+      ShaderBuild::start(vertex_shader_file, fragment_shader_file, options),
+    .shader = nullptr,
+  });
+
+  return entries.size() - 1;
+}
+
+bool ShaderCompiler::is_ready(uint32_t index) const {
+  auto &entry = entries.at(index);
+
+  return entry.shader || entry.build.is_complete();
+}
+
+bool ShaderCompiler::is_ready() const {
+  for (uint32_t index = 0; index < entries.size(); index++) {
+    if (!is_ready(index)) return false;
+  }
+
+  return true;
+}
+
+std::shared_ptr<Shader> ShaderCompiler::take(uint32_t index) {
+  auto &entry = entries.at(index);
+
+  if (!entry.shader) {
+    entry.shader = std::make_shared<Shader>(std::move(entry.build));
+  }
+
+  return entry.shader;
+}
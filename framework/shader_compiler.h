@@ -0,0 +1,40 @@
+#pragma once
+
+#include "framework/shader.h"
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <vector>
+
+namespace framework {
+  /// Starts compiling and linking many shaders up front, and only waits for
+  /// a shader when it is taken. With `GL_KHR_parallel_shader_compile` the
+  /// driver compiles them on its own threads, so a loading frame can be shown
+  /// until `is_ready` returns true.
+  struct ShaderCompiler {
+    struct Entry {
+      ShaderBuild build;
+      std::shared_ptr<Shader> shader;
+    };
+
+    std::vector<Entry> entries;
+
+    ShaderCompiler();
+
+    /// Starts a build, the returned index is used to take the shader
+    uint32_t add(
+      std::filesystem::path vertex_shader_file,
+      std::filesystem::path fragment_shader_file,
+      ShaderOptions options = {}
+    );
+
+    /// Never blocks
+    bool is_ready(uint32_t index) const;
+
+    /// Never blocks, true when every shader is ready
+    bool is_ready() const;
+
+    /// Finishes the shader, waiting for the driver if it is not ready yet
+    std::shared_ptr<Shader> take(uint32_t index);
+  };
+}
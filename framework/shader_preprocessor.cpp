@@ -0,0 +1,104 @@
+#include "shader_preprocessor.h"
+#include <algorithm>
+#include <format>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+using namespace framework;
+
+static std::string read_file_to_string(const std::filesystem::path &path) {
+  std::ifstream file(path);
+  if (!file) {
+    throw std::runtime_error("Failed to open shader file " + path.string());
+  }
+
+  std::string content(
+    (std::istreambuf_iterator<char>(file)), (std::istreambuf_iterator<char>())
+  );
+
+  return content;
+}
+
+static std::string_view trim_start(std::string_view line) {
+  auto start = line.find_first_not_of(" \t");
+
+  return start == std::string_view::npos ? "" : line.substr(start);
+}
+
+static void expand_file(
+  const std::filesystem::path &path,
+  std::span<const ShaderDefine> defines,
+  std::vector<std::filesystem::path> &include_stack,
+  PreprocessedShader &output
+) {
+  if (std::ranges::find(include_stack, path) != include_stack.end()) {
+    throw std::runtime_error("Shader include cycle at " + path.string());
+  }
+
+  auto file_index = output.files.size();
+  output.files.push_back(path);
+  include_stack.push_back(path);
+
+  auto is_root = include_stack.size() == 1;
+  auto defines_injected = !is_root;
+
+  std::istringstream content(read_file_to_string(path));
+  std::string line;
+  uint32_t line_number = 0;
+
+  while (std::getline(content, line)) {
+    line_number++;
+    auto directive = trim_start(line);
+
+    // Defines go after `#version`, which has to be the first statement
+    if (!defines_injected && !directive.starts_with("#version") &&
+        !directive.empty() && !directive.starts_with("//")) {
+      for (auto &define : defines) {
+        output.source +=
+          std::format("#define {} {}\n", define.name, define.value);
+      }
+
+      output.source += std::format("#line {} {}\n", line_number, file_index);
+      defines_injected = true;
+    }
+
+    if (directive.starts_with("#include")) {
+      auto start = directive.find_first_of("\"<");
+      auto end = directive.find_last_of("\">");
+
+      if (start == std::string_view::npos || end <= start) {
+        throw std::runtime_error(std::format(
+          "Malformed include in {}:{}", path.string(), line_number
+        ));
+      }
+
+      auto included = directive.substr(start + 1, end - start - 1);
+
+      output.source += std::format("#line 1 {}\n", output.files.size());
+      expand_file(
+        path.parent_path() / included, defines, include_stack, output
+      );
+      output.source +=
+        std::format("#line {} {}\n", line_number + 1, file_index);
+
+      continue;
+    }
+
+    output.source += line;
+    output.source += '\n';
+  }
+
+  include_stack.pop_back();
+}
+
+PreprocessedShader framework::preprocess_shader(
+  const std::filesystem::path &path, std::span<const ShaderDefine> defines
+) {
+  PreprocessedShader output;
+  std::vector<std::filesystem::path> include_stack;
+
+  expand_file(path, defines, include_stack, output);
+
+  return output;
+}
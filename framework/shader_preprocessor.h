@@ -0,0 +1,27 @@
+#pragma once
+
+#include <filesystem>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace framework {
+  struct ShaderDefine {
+    std::string name;
+    std::string value = "1";
+  };
+
+  struct PreprocessedShader {
+    std::string source;
+
+    // The file itself followed by every file it included, `#line`
+    // directives refer to files by their index in here
+    std::vector<std::filesystem::path> files;
+  };
+
+  /// Expands `#include "file"` directives relative to the including file,
+  /// and injects `defines` right after the `#version` line.
+  PreprocessedShader preprocess_shader(
+    const std::filesystem::path &path, std::span<const ShaderDefine> defines
+  );
+}
@@ -0,0 +1,104 @@
+#include "shader_variants.h"
+#include "internal.h"
+#include <algorithm>
+
+using namespace framework;
+using internal::hash_bytes;
+
+/// Calls `visit` with every define of `base` followed by `extra` that isn't
+/// overridden by a later one with the same name
+template <typename Visit>
+static void for_each_merged_define(
+  std::span<const ShaderDefine> base,
+  std::span<const ShaderDefine> extra,
+  Visit visit
+) {
+  auto overridden = [&](const ShaderDefine &define, size_t position) {
+    auto later = [&](std::span<const ShaderDefine> defines, size_t start) {
+      return std::ranges::any_of(
+        defines.subspan(std::min(start, defines.size())),
+        [&](auto &other) { return other.name == define.name; }
+      );
+    };
+
+    if (position < base.size()) {
+      return later(base, position + 1) || later(extra, 0);
+    }
+
+    return later(extra, position - base.size() + 1);
+  };
+
+  for (size_t i = 0; i < base.size() + extra.size(); i++) {
+    auto &define = i < base.size() ? base[i] : extra[i - base.size()];
+    if (!overridden(define, i)) visit(define);
+  }
+}
+
+static uint64_t hash_define(const ShaderDefine &define) {
+  auto hash = hash_bytes(define.name, 0xcbf29ce484222325);
+  hash = hash_bytes(std::string_view("\0", 1), hash);
+  hash = hash_bytes(define.value, hash);
+
+  // FNV mixes the last bytes poorly, and the hashes get summed
+  hash ^= hash >> 33;
+  hash *= 0xff51afd7ed558ccd;
+  hash ^= hash >> 33;
+
+  return hash;
+}
+
+ShaderVariants::ShaderVariants(
+  std::vector<ShaderStageFile> stage_files, ShaderOptions options
+) :
+  stage_files(std::move(stage_files)), options(std::move(options)) {}
+
+std::shared_ptr<Shader> ShaderVariants::get(
+  std::span<const ShaderDefine> defines
+) {
+  // Names are unique after merging, so summing keeps the hash independent
+  // of the order the defines were given in
+  uint64_t hash = 0;
+  size_t define_count = 0;
+  for_each_merged_define(options.defines, defines, [&](auto &define) {
+    hash += hash_define(define);
+    define_count++;
+  });
+
+  auto &bucket = variants[hash];
+  for (auto &variant : bucket) {
+    if (variant.defines.size() != define_count) continue;
+
+    bool matches = true;
+    for_each_merged_define(options.defines, defines, [&](auto &define) {
+      auto other = std::ranges::lower_bound(
+        variant.defines, define.name, {}, &ShaderDefine::name
+      );
+
+      matches = matches && other != variant.defines.end() &&
+                other->name == define.name && other->value == define.value;
+    });
+
+    if (matches) return variant.shader;
+  }
+
+  auto variant_options = options;
+  variant_options.defines.clear();
+  for_each_merged_define(options.defines, defines, [&](auto &define) {
+    variant_options.defines.push_back(define);
+  });
+  std::ranges::sort(variant_options.defines, {}, &ShaderDefine::name);
+
+  auto merged_defines = variant_options.defines;
+  auto shader = std::make_shared<Shader>(
+    ShaderBuild::start(stage_files, std::move(variant_options))
+  );
+  bucket.push_back({std::move(merged_defines), shader});
+
+  return shader;
+}
+
+std::shared_ptr<Shader> ShaderVariants::get(
+  std::initializer_list<ShaderDefine> defines
+) {
+  return get(std::span(defines.begin(), defines.end()));
+}
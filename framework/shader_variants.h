@@ -0,0 +1,39 @@
+#pragma once
+
+#include "framework/shader.h"
+#include <cstdint>
+#include <initializer_list>
+#include <memory>
+#include <span>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace framework {
+  /// Permutations of one shader, built from the same stage files with
+  /// different `#define`s. Each set of defines is only compiled once.
+  struct ShaderVariants {
+    std::vector<ShaderStageFile> stage_files;
+    ShaderOptions options;
+
+    struct Variant {
+      // Merged defines of the variant, sorted by name
+      std::vector<ShaderDefine> defines;
+      std::shared_ptr<Shader> shader;
+    };
+
+    // Keyed by a hash of the merged defines, which doesn't depend on their
+    // order. Variants whose hashes collide share a bucket.
+    std::unordered_map<uint64_t, std::vector<Variant>> variants;
+
+    ShaderVariants(
+      std::vector<ShaderStageFile> stage_files, ShaderOptions options = {}
+    );
+
+    /// Defines are added after the ones already in `options`, a define
+    /// given more than once takes its last value. Finding an existing
+    /// variant doesn't allocate.
+    std::shared_ptr<Shader> get(std::span<const ShaderDefine> defines);
+    std::shared_ptr<Shader> get(std::initializer_list<ShaderDefine> defines);
+  };
+}
@@ -0,0 +1,173 @@
+#include "shader_watcher.h"
+#include <algorithm>
+#include <array>
+#include <iostream>
+#include <stdexcept>
+
+#ifdef __linux__
+  #include <sys/inotify.h>
+  #include <unistd.h>
+#endif
+
+using namespace framework;
+
+static std::filesystem::path normalize(const std::filesystem::path &path) {
+  std::error_code error;
+  auto canonical = std::filesystem::weakly_canonical(path, error);
+
+  return error ? path : canonical;
+}
+
+static std::filesystem::file_time_type write_time_of(
+  const std::filesystem::path &file
+) {
+  std::error_code error;
+  auto write_time = std::filesystem::last_write_time(file, error);
+
+  return error ? std::filesystem::file_time_type::min() : write_time;
+}
+
+ShaderWatcher::ShaderWatcher() {
+#ifdef __linux__
+  inotify_fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+
+  if (inotify_fd == -1) {
+    std::cerr << "Failed to initialize inotify, polling shader files\n";
+  }
+#endif
+}
+
+ShaderWatcher::~ShaderWatcher() {
+#ifdef __linux__
+  if (inotify_fd != -1) close(inotify_fd);
+#endif
+}
+
+void ShaderWatcher::watch_directory(const std::filesystem::path &directory) {
+#ifdef __linux__
+  if (inotify_fd == -1) return;
+
+  auto already_watched = std::ranges::any_of(
+    watched_directories,
+    [&](auto &watched) { return watched.second == directory; }
+  );
+  if (already_watched) return;
+
+  // Watch the directory rather than the file, editors often save by
+  // replacing the file
+  auto descriptor = inotify_add_watch(
+    inotify_fd, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE
+  );
+
+  if (descriptor != -1) watched_directories.emplace_back(descriptor, directory);
+#endif
+}
+
+void ShaderWatcher::watch_files(WatchedShader &watched_shader) {
+  auto shader = watched_shader.shader.lock();
+
+  watched_shader.files.clear();
+  watched_shader.write_times.clear();
+
+  for (auto &source_file : shader->source_files) {
+    auto file = normalize(source_file);
+
+    watched_shader.files.push_back(file);
+    watched_shader.write_times.push_back(write_time_of(file));
+    watch_directory(file.parent_path());
+  }
+}
+
+void ShaderWatcher::watch(std::shared_ptr<Shader> shader) {
+  WatchedShader watched_shader{.shader = shader};
+  watch_files(watched_shader);
+
+  watched_shaders.push_back(std::move(watched_shader));
+}
+
+void ShaderWatcher::mark_changed(const std::filesystem::path &file) {
+  for (auto &watched_shader : watched_shaders) {
+    if (std::ranges::find(watched_shader.files, file) !=
+        watched_shader.files.end()) {
+      watched_shader.changed_at = std::chrono::steady_clock::now();
+    }
+  }
+}
+
+void ShaderWatcher::poll() {
+  std::erase_if(watched_shaders, [](auto &watched_shader) {
+    return watched_shader.shader.expired();
+  });
+
+#ifdef __linux__
+  if (inotify_fd != -1) {
+    alignas(inotify_event) std::array<char, 4096> events;
+
+    while (true) {
+      auto length = read(inotify_fd, events.data(), events.size());
+      if (length <= 0) break;
+
+      for (auto offset = 0; offset < length;) {
+        auto event = reinterpret_cast<inotify_event *>(events.data() + offset);
+        offset += sizeof(inotify_event) + event->len;
+
+        if (event->len == 0) continue;
+
+        auto directory = std::ranges::find_if(
+          watched_directories,
+          [&](auto &watched) { return watched.first == event->wd; }
+        );
+
+        if (directory != watched_directories.end()) {
+          mark_changed(directory->second / event->name);
+        }
+      }
+    }
+  }
+#endif
+
+  auto now = std::chrono::steady_clock::now();
+
+  for (auto &watched_shader : watched_shaders) {
+    // Without inotify, fall back to comparing modification times
+    if (inotify_fd == -1) {
+      for (uint32_t i = 0; i < watched_shader.files.size(); i++) {
+        auto write_time = write_time_of(watched_shader.files[i]);
+
+        if (write_time != watched_shader.write_times[i]) {
+          watched_shader.write_times[i] = write_time;
+          watched_shader.changed_at = now;
+        }
+      }
+    }
+
+    auto shader = watched_shader.shader.lock();
+
+    if (watched_shader.changed_at.has_value() &&
+        now - watched_shader.changed_at.value() >= debounce) {
+      watched_shader.changed_at = std::nullopt;
+
+      // Starts compiling in the background when parallel compilation is
+      // supported, a newer change replaces a build still in progress
+      try {
+        watched_shader.build =
+          ShaderBuild::start(shader->stage_files, shader->options);
+      } catch (const std::runtime_error &error) {
+        std::cerr << error.what() << ", keeping the previous program\n";
+      }
+    }
+
+    if (watched_shader.build.has_value() &&
+        watched_shader.build->is_complete()) {
+      auto build = std::move(watched_shader.build.value());
+      watched_shader.build = std::nullopt;
+
+      if (shader->reload(std::move(build))) {
+        std::cout << "Reloaded shader " << watched_shader.files.front() << "\n";
+
+        // Includes may have changed
+        watch_files(watched_shader);
+      }
+    }
+  }
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include "framework/shader.h"
+#include <chrono>
+#include <filesystem>
+#include <memory>
+#include <optional>
+#include <vector>
+
+namespace framework {
+  /// Rebuilds shaders when their source files change. Uses inotify on Linux
+  /// and modification times elsewhere.
+  struct ShaderWatcher {
+    struct WatchedShader {
+      std::weak_ptr<Shader> shader;
+      std::vector<std::filesystem::path> files;
+      std::vector<std::filesystem::file_time_type> write_times;
+      std::optional<std::chrono::steady_clock::time_point> changed_at;
+      std::optional<ShaderBuild> build;
+    };
+
+    std::vector<WatchedShader> watched_shaders;
+
+    // Waits for changes to settle, editors often write a file several times
+    std::chrono::milliseconds debounce = std::chrono::milliseconds(100);
+
+    int32_t inotify_fd = -1;
+    std::vector<std::pair<int32_t, std::filesystem::path>> watched_directories;
+
+    ShaderWatcher();
+
+    ~ShaderWatcher();
+
+    ShaderWatcher(const ShaderWatcher &) = delete;
+
+    ShaderWatcher &operator=(const ShaderWatcher &) = delete;
+
+    void watch(std::shared_ptr<Shader> shader);
+
+    /// Checks for changes and swaps in finished rebuilds. Call once per
+    /// frame on the thread owning the GL context.
+    void poll();
+
+  private:
+    void mark_changed(const std::filesystem::path &file);
+
+    void watch_files(WatchedShader &watched_shader);
+
+    void watch_directory(const std::filesystem::path &directory);
+  };
+}
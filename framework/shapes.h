@@ -1,5 +1,6 @@
 #pragma once
 
+#include "framework/buffer.h"
 #include <glm/glm.hpp>
 #include <vector>
 
@@ -11,7 +12,7 @@ namespace framework::shapes {
 
   struct Bindings {
     std::vector<Vertex> vertices;
-    std::vector<uint32_t> indices;
+    IndexData indices;
   };
 
   const Bindings triangle{
@@ -19,7 +20,7 @@ namespace framework::shapes {
       {{.position = {-0.5f, -0.5f, 0.0f}, .texture_coordinate = {0.0f, 0.0f}},
        {.position = {0.5f, -0.5f, 0.0f}, .texture_coordinate = {1.0f, 0.0f}},
        {.position = {0.0f, 0.5f, 0.0f}, .texture_coordinate = {0.5f, 1.0f}}},
-    .indices = {0, 1, 2}
+    .indices = IndexData({0, 1, 2}, 3)
   };
 
   const Bindings quad = {
@@ -28,11 +29,11 @@ namespace framework::shapes {
        {.position = {0.5f, -0.5f, 0.0f}, .texture_coordinate = {1.0f, 0.0f}},
        {.position = {0.5f, 0.5f, 0.0f}, .texture_coordinate = {1.0f, 1.0f}},
        {.position = {-0.5f, 0.5f, 0.0f}, .texture_coordinate = {0.0f, 1.0f}}},
-    .indices = {0, 1, 2, 2, 3, 0}
+    .indices = IndexData({0, 1, 2, 2, 3, 0}, 4)
   };
 
   // unit grid from centered at origin from -0.5 to 0.5
-  Bindings grid(uint32_t rows, uint32_t columns) {
+  inline Bindings grid(uint32_t rows, uint32_t columns) {
     // Add 1 since we calculate as if each line is a row or column
     rows += 1;
     columns += 1;
@@ -69,6 +70,9 @@ namespace framework::shapes {
       }
     }
 
-    return {.vertices = vertices, .indices = indices};
+    return {
+      .vertices = vertices,
+      .indices = IndexData(indices, vertices.size()),
+    };
   }
 }
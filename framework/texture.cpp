@@ -1,5 +1,11 @@
 #include "texture.h"
+#include "mipmap.h"
+#include "texture_cache.h"
 #include <GL/glew.h>
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <span>
 #include <stdexcept>
 
 struct Pixels {
@@ -18,6 +24,14 @@ static Pixels loadPixels(const std::string &path) {
   return {.width = width, .height = height, .pixels = pixels};
 }
 
+static uint32_t levelCountOf(
+  framework::Filtering filtering, int width, int height
+) {
+  if (filtering != framework::Filtering::LinearMipmap) return 1;
+
+  return framework::mip_level_count(width, height);
+}
+
 static void applyTextureParameters(
   uint32_t textureId,
   framework::Filtering filtering,
@@ -50,8 +64,6 @@ static void applyTextureParameters(
       break;
 
     case framework::Filtering::LinearMipmap:
-      glGenerateTextureMipmap(textureId);
-
       glTextureParameteri(
         textureId, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR
       );
@@ -62,10 +74,11 @@ static void applyTextureParameters(
 }
 
 namespace framework {
-  Texture::Texture(uint32_t id, stbi_uc *pixels) : id(id), pixels(pixels) {}
+  Texture::Texture(uint32_t id, stbi_uc *pixels, uint64_t bytes) :
+    id(id), pixels(pixels), bytes(bytes) {}
 
   Texture::Texture(Texture &&texture) noexcept :
-    id(texture.id), pixels(texture.pixels) {
+    id(texture.id), pixels(texture.pixels), bytes(texture.bytes) {
     texture.id = 0;
     texture.pixels = nullptr;
   }
@@ -75,19 +88,110 @@ namespace framework {
     if (pixels) stbi_image_free((void *)pixels);
   }
 
-  void Texture::bind() const {
-    glBindTextureUnit(0, id);
+  void Texture::bind(uint32_t unit) const {
+    glBindTextureUnit(unit, id);
   }
 
   Texture loadTexture(
     const std::string &path, Filtering filtering, Wrapping wrapping
   ) {
-    auto [imageWidth, imageHeight, pixels] = loadPixels(path);
+    return loadTexture(
+      path, TextureOptions{.filtering = filtering, .wrapping = wrapping}
+    );
+  }
+
+  uint32_t createTexture(
+    int width, int height, const TextureOptions &options
+  ) {
+    auto levelCount = levelCountOf(options.filtering, width, height);
+    auto internalFormat = options.srgb ? GL_SRGB8_ALPHA8 : GL_RGBA8;
 
     uint32_t textureId;
     glCreateTextures(GL_TEXTURE_2D, 1, &textureId);
+    glTextureStorage2D(textureId, levelCount, internalFormat, width, height);
+
+    return textureId;
+  }
+
+  uint64_t textureGpuBytes(
+    int width, int height, const TextureOptions &options
+  ) {
+    auto levelCount = levelCountOf(options.filtering, width, height);
+
+    uint64_t bytes = 0;
+    for (uint32_t level = 0; level < levelCount; level++) {
+      uint64_t levelWidth = std::max(width >> level, 1);
+      uint64_t levelHeight = std::max(height >> level, 1);
+
+      bytes += levelWidth * levelHeight * 4;
+    }
+
+    return bytes;
+  }
+
+  void finishTexture(uint32_t textureId, const TextureOptions &options) {
+    if (options.filtering == Filtering::LinearMipmap &&
+        options.mipmap_generator == MipmapGenerator::Driver) {
+      glGenerateTextureMipmap(textureId);
+    }
+
+    applyTextureParameters(textureId, options.filtering, options.wrapping);
+  }
+
+  static Texture uploadCachedTexture(
+    const CachedTexture &cached, const TextureOptions &options
+  ) {
+    auto &header = cached.header();
+    auto textureId = createTexture(header.width, header.height, options);
+
+    // Uploaded straight from the mapped file
+    for (uint32_t level = 0; level < header.level_count; level++) {
+      auto &cacheLevel = header.levels[level];
+
+      glTextureSubImage2D(
+        textureId,
+        level,
+        0,
+        0,
+        cacheLevel.width,
+        cacheLevel.height,
+        GL_RGBA,
+        GL_UNSIGNED_BYTE,
+        cached.level(level).data()
+      );
+    }
+
+    finishTexture(textureId, options);
+
+    // Allocated like stb_image does, so the texture can free it the same way
+    stbi_uc *pixels = nullptr;
+    if (options.keep_cpu_copy) {
+      auto basePixels = cached.level(0);
+
+      pixels = static_cast<stbi_uc *>(std::malloc(basePixels.size()));
+      std::memcpy(pixels, basePixels.data(), basePixels.size());
+    }
+
+    auto bytes = textureGpuBytes(header.width, header.height, options);
+
+    return {textureId, pixels, bytes};
+  }
 
-    glTextureStorage2D(textureId, 1, GL_RGBA8, imageWidth, imageHeight);
+  Texture loadTexture(const std::string &path, const TextureOptions &options) {
+    std::optional<std::filesystem::path> cachePath;
+
+    if (options.cache_directory.has_value()) {
+      cachePath =
+        textureCachePath(options.cache_directory.value(), path, options);
+
+      if (auto cached = readTextureCache(cachePath.value(), options)) {
+        return uploadCachedTexture(cached.value(), options);
+      }
+    }
+
+    auto [imageWidth, imageHeight, pixels] = loadPixels(path);
+
+    auto textureId = createTexture(imageWidth, imageHeight, options);
     glTextureSubImage2D(
       textureId,
       0,
@@ -100,9 +204,49 @@ namespace framework {
       pixels
     );
 
-    applyTextureParameters(textureId, filtering, wrapping);
+    std::vector<MipLevel> levels;
+
+    auto levelCount = levelCountOf(options.filtering, imageWidth, imageHeight);
+    if (levelCount > 1 && options.mipmap_generator == MipmapGenerator::Cpu) {
+      std::span<const uint8_t> basePixels(
+        pixels, static_cast<size_t>(imageWidth) * imageHeight * 4
+      );
+      levels =
+        build_mip_chain(basePixels, imageWidth, imageHeight, options.srgb);
+
+      for (uint32_t level = 1; level < levelCount; level++) {
+        auto &mip = levels[level - 1];
+
+        glTextureSubImage2D(
+          textureId,
+          level,
+          0,
+          0,
+          mip.width,
+          mip.height,
+          GL_RGBA,
+          GL_UNSIGNED_BYTE,
+          mip.pixels.data()
+        );
+      }
+    }
+
+    finishTexture(textureId, options);
 
-    return {textureId, pixels};
+    if (cachePath.has_value()) {
+      writeTextureCache(
+        cachePath.value(), imageWidth, imageHeight, pixels, levels
+      );
+    }
+
+    if (!options.keep_cpu_copy) {
+      stbi_image_free(pixels);
+      pixels = nullptr;
+    }
+
+    auto bytes = textureGpuBytes(imageWidth, imageHeight, options);
+
+    return {textureId, pixels, bytes};
   }
 
   Texture loadCubemap(
@@ -110,10 +254,14 @@ namespace framework {
   ) {
     auto [imageWidth, imageHeight, pixels] = loadPixels(path);
 
+    auto levelCount = levelCountOf(filtering, imageWidth, imageHeight);
+
     uint32_t textureId;
     glCreateTextures(GL_TEXTURE_CUBE_MAP, 1, &textureId);
 
-    glTextureStorage2D(textureId, 1, GL_RGBA8, imageWidth, imageHeight);
+    glTextureStorage2D(
+      textureId, levelCount, GL_RGBA8, imageWidth, imageHeight
+    );
     for (int i = 0; i < 6; ++i) {
       glTextureSubImage3D(
         textureId,
@@ -130,8 +278,16 @@ namespace framework {
       );
     }
 
+    if (levelCount > 1) glGenerateTextureMipmap(textureId);
+
     applyTextureParameters(textureId, filtering, wrapping);
 
-    return {textureId, pixels};
+    stbi_image_free(pixels);
+
+    auto faceBytes = textureGpuBytes(
+      imageWidth, imageHeight, TextureOptions{.filtering = filtering}
+    );
+
+    return {textureId, nullptr, faceBytes * 6};
   }
 }
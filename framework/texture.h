@@ -2,6 +2,8 @@
 
 #include "stb_image.h"
 #include <cstdint>
+#include <filesystem>
+#include <optional>
 #include <string>
 
 namespace framework {
@@ -9,13 +11,39 @@ namespace framework {
 
   enum class Wrapping { Repeat };
 
+  enum class MipmapGenerator {
+    // `glGenerateTextureMipmap`, filter quality depends on the driver
+    Driver,
+    // Box filter on the CPU, gamma correct for sRGB textures
+    Cpu,
+  };
+
+  struct TextureOptions {
+    Filtering filtering = Filtering::LinearMipmap;
+    Wrapping wrapping = Wrapping::Repeat;
+
+    // Stored as `GL_SRGB8_ALPHA8`, so sampling returns linear colors
+    bool srgb = false;
+
+    MipmapGenerator mipmap_generator = MipmapGenerator::Driver;
+
+    // Keeps the decoded pixels after the upload, for users that read them
+    // back. They are freed right away otherwise.
+    bool keep_cpu_copy = false;
+
+    // Decoded levels are cached in this directory when set, so later runs
+    // upload them without decoding the image again
+    std::optional<std::filesystem::path> cache_directory = std::nullopt;
+  };
+
   class Texture {
   private:
     uint32_t id;
     stbi_uc *pixels;
+    uint64_t bytes;
 
   public:
-    Texture(uint32_t id, stbi_uc *pixels);
+    Texture(uint32_t id, stbi_uc *pixels, uint64_t bytes = 0);
 
     Texture(Texture &&texture) noexcept;
 
@@ -25,7 +53,17 @@ namespace framework {
 
     Texture &operator=(const Texture &) = delete;
 
-    void bind() const;
+    void bind(uint32_t unit = 0) const;
+
+    /// Video memory used by all levels
+    uint64_t gpu_bytes() const {
+      return bytes;
+    }
+
+    /// RGBA8 pixels of level 0, only kept with `keep_cpu_copy`
+    const stbi_uc *cpu_pixels() const {
+      return pixels;
+    }
   };
 
   Texture loadTexture(
@@ -34,6 +72,20 @@ namespace framework {
     Wrapping wrapping = Wrapping::Repeat
   );
 
+  Texture loadTexture(const std::string &path, const TextureOptions &options);
+
+  /// Creates an RGBA8 2D texture with storage for every level `options`
+  /// needs. Upload the levels, then call `finishTexture`.
+  uint32_t createTexture(int width, int height, const TextureOptions &options);
+
+  /// Size of an RGBA8 texture with the levels `options` needs
+  uint64_t textureGpuBytes(
+    int width, int height, const TextureOptions &options
+  );
+
+  /// Generates driver mipmaps if requested and applies the sampling options
+  void finishTexture(uint32_t textureId, const TextureOptions &options);
+
   Texture loadCubemap(
     const std::string &path,
     Filtering filtering = Filtering::LinearMipmap,
@@ -0,0 +1,233 @@
+#include "texture_array.h"
+#include "internal.h"
+#include "mipmap.h"
+#include <GL/glew.h>
+#include <algorithm>
+#include <bit>
+#include <format>
+#include <numeric>
+#include <span>
+#include <stdexcept>
+
+using namespace framework;
+using internal::align_up;
+
+struct Placement {
+  uint32_t layer;
+  uint32_t x;
+  uint32_t y;
+};
+
+TextureArray::TextureArray(
+  uint32_t id,
+  uint32_t layer_width,
+  uint32_t layer_height,
+  uint32_t layer_count,
+  std::vector<AtlasRegion> regions
+) :
+  id(id), layer_width(layer_width), layer_height(layer_height),
+  layer_count(layer_count), regions(std::move(regions)) {}
+
+TextureArray::TextureArray(TextureArray &&texture_array) noexcept :
+  id(texture_array.id), layer_width(texture_array.layer_width),
+  layer_height(texture_array.layer_height),
+  layer_count(texture_array.layer_count),
+  regions(std::move(texture_array.regions)) {
+  texture_array.id = 0;
+}
+
+TextureArray::~TextureArray() {
+  if (id) glDeleteTextures(1, &id);
+}
+
+void TextureArray::bind(uint32_t unit) const {
+  glBindTextureUnit(unit, id);
+}
+
+TextureArrayBuilder::TextureArrayBuilder(
+  uint32_t layer_size, uint32_t padding
+) :
+  layer_size(layer_size), padding(padding) {}
+
+TextureArrayBuilder::~TextureArrayBuilder() {
+  for (auto &image : images) stbi_image_free(image.pixels);
+}
+
+uint32_t TextureArrayBuilder::add(const std::string &path) {
+  int width, height, channels;
+  auto pixels = stbi_load(path.c_str(), &width, &height, &channels, 4);
+  if (!pixels) {
+    throw std::runtime_error(std::format("Failed to load image {}.", path));
+  }
+
+  images.push_back({
+    .path = path,
+    .width = static_cast<uint32_t>(width),
+    .height = static_cast<uint32_t>(height),
+    .pixels = pixels,
+  });
+
+  return images.size() - 1;
+}
+
+TextureArray TextureArrayBuilder::build(const TextureOptions &options) {
+  if (images.empty()) {
+    throw std::runtime_error("Texture array has no images.");
+  }
+
+  // Regions start at multiples of the border, so each mip level it covers
+  // still has at least one pixel of border between images
+  uint32_t border = padding ? std::bit_ceil(padding) : 0;
+  auto padded = [&](uint32_t size) {
+    return align_up(size, std::max(border, 1u)) + border * 2;
+  };
+
+  auto size = layer_size;
+  if (size == 0) {
+    for (auto &image : images) {
+      size = std::max({size, padded(image.width), padded(image.height)});
+    }
+  }
+
+  // Shelf packing, tallest images first
+  std::vector<uint32_t> order(images.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::ranges::sort(order, [&](uint32_t left, uint32_t right) {
+    return images[left].height > images[right].height;
+  });
+
+  std::vector<Placement> placements(images.size());
+  Placement cursor{.layer = 0, .x = 0, .y = 0};
+  uint32_t shelf_height = 0;
+
+  for (auto index : order) {
+    auto &image = images[index];
+    auto width = padded(image.width);
+    auto height = padded(image.height);
+
+    if (width > size || height > size) {
+      throw std::runtime_error(std::format(
+        "Image {} does not fit in a {}x{} layer.", image.path, size, size
+      ));
+    }
+
+    if (cursor.x + width > size) {
+      cursor.x = 0;
+      cursor.y += shelf_height;
+      shelf_height = 0;
+    }
+
+    if (cursor.y + height > size) {
+      cursor = {.layer = cursor.layer + 1, .x = 0, .y = 0};
+      shelf_height = 0;
+    }
+
+    placements[index] = cursor;
+    cursor.x += width;
+    shelf_height = std::max(shelf_height, height);
+  }
+
+  auto layer_count = cursor.layer + 1;
+
+  // Levels past the border would blend neighbouring images
+  uint32_t level_count = 1;
+  if (options.filtering == Filtering::LinearMipmap) {
+    level_count = std::min(
+      mip_level_count(size, size), std::max<uint32_t>(std::bit_width(border), 1)
+    );
+  }
+
+  auto internal_format = options.srgb ? GL_SRGB8_ALPHA8 : GL_RGBA8;
+
+  uint32_t texture_id;
+  glCreateTextures(GL_TEXTURE_2D_ARRAY, 1, &texture_id);
+  glTextureStorage3D(
+    texture_id, level_count, internal_format, size, size, layer_count
+  );
+
+  std::vector<AtlasRegion> regions(images.size());
+  std::vector<uint8_t> layer_pixels(static_cast<size_t>(size) * size * 4);
+
+  for (uint32_t layer = 0; layer < layer_count; layer++) {
+    std::ranges::fill(layer_pixels, 0);
+
+    for (uint32_t index = 0; index < images.size(); index++) {
+      auto &image = images[index];
+      auto placement = placements[index];
+      if (placement.layer != layer) continue;
+
+      auto left = placement.x + border;
+      auto top = placement.y + border;
+
+      // Copies the image, repeating its edge pixels through the rest of
+      // its cell, including the alignment gap after the image
+      auto bottom = placement.y + padded(image.height);
+      auto right = placement.x + padded(image.width);
+
+      for (uint32_t y = placement.y; y < bottom; y++) {
+        auto source_y = std::clamp<int64_t>(
+          static_cast<int64_t>(y) - top, 0, image.height - 1
+        );
+
+        for (uint32_t x = placement.x; x < right; x++) {
+          auto source_x = std::clamp<int64_t>(
+            static_cast<int64_t>(x) - left, 0, image.width - 1
+          );
+
+          std::copy_n(
+            &image.pixels[(source_y * image.width + source_x) * 4],
+            4,
+            &layer_pixels[(static_cast<size_t>(y) * size + x) * 4]
+          );
+        }
+      }
+
+      regions[index] = {
+        .layer = layer,
+        .uv_offset = glm::vec2(left, top) / static_cast<float>(size),
+        .uv_scale =
+          glm::vec2(image.width, image.height) / static_cast<float>(size),
+      };
+    }
+
+    glTextureSubImage3D(
+      texture_id,
+      0,
+      0,
+      0,
+      layer,
+      size,
+      size,
+      1,
+      GL_RGBA,
+      GL_UNSIGNED_BYTE,
+      layer_pixels.data()
+    );
+
+    if (level_count > 1 && options.mipmap_generator == MipmapGenerator::Cpu) {
+      auto levels = build_mip_chain(layer_pixels, size, size, options.srgb);
+
+      for (uint32_t level = 1; level < level_count; level++) {
+        auto &mip = levels[level - 1];
+
+        glTextureSubImage3D(
+          texture_id,
+          level,
+          0,
+          0,
+          layer,
+          mip.width,
+          mip.height,
+          1,
+          GL_RGBA,
+          GL_UNSIGNED_BYTE,
+          mip.pixels.data()
+        );
+      }
+    }
+  }
+
+  finishTexture(texture_id, options);
+
+  return {texture_id, size, size, layer_count, std::move(regions)};
+}
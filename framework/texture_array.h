@@ -0,0 +1,80 @@
+#pragma once
+
+#include "framework/texture.h"
+#include <glm/glm.hpp>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace framework {
+  /// Where an image ended up in a `TextureArray`, sample it with
+  /// `vec3(uv_offset + uv * uv_scale, layer)` from a `sampler2DArray`
+  struct AtlasRegion {
+    uint32_t layer;
+    glm::vec2 uv_offset;
+    glm::vec2 uv_scale;
+  };
+
+  class TextureArray {
+  private:
+    uint32_t id;
+
+  public:
+    uint32_t layer_width;
+    uint32_t layer_height;
+    uint32_t layer_count;
+
+    // Indexed by the value `TextureArrayBuilder::add` returned
+    std::vector<AtlasRegion> regions;
+
+    TextureArray(
+      uint32_t id,
+      uint32_t layer_width,
+      uint32_t layer_height,
+      uint32_t layer_count,
+      std::vector<AtlasRegion> regions
+    );
+
+    TextureArray(TextureArray &&texture_array) noexcept;
+
+    ~TextureArray();
+
+    TextureArray(const TextureArray &) = delete;
+
+    TextureArray &operator=(const TextureArray &) = delete;
+
+    void bind(uint32_t unit = 0) const;
+  };
+
+  /// Packs images into the layers of a `GL_TEXTURE_2D_ARRAY`, several small
+  /// images share a layer. Each image is surrounded by `padding` pixels of
+  /// its own edge, so filtering and the first mip levels don't bleed in
+  /// neighbouring images.
+  struct TextureArrayBuilder {
+    struct Image {
+      std::string path;
+      uint32_t width;
+      uint32_t height;
+      stbi_uc *pixels;
+    };
+
+    uint32_t layer_size;
+    uint32_t padding;
+    std::vector<Image> images;
+
+    /// A `layer_size` of 0 fits the largest image, so images of the same
+    /// size get a layer each
+    explicit TextureArrayBuilder(uint32_t layer_size = 0, uint32_t padding = 8);
+
+    ~TextureArrayBuilder();
+
+    TextureArrayBuilder(const TextureArrayBuilder &) = delete;
+
+    TextureArrayBuilder &operator=(const TextureArrayBuilder &) = delete;
+
+    /// Loads the image, returns the index of its region
+    uint32_t add(const std::string &path);
+
+    TextureArray build(const TextureOptions &options = {});
+  };
+}
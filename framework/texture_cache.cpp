@@ -0,0 +1,250 @@
+#include "texture_cache.h"
+#include "internal.h"
+#include <algorithm>
+#include <cstring>
+#include <format>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <thread>
+
+#if defined(__unix__) || defined(__APPLE__)
+  #include <fcntl.h>
+  #include <sys/mman.h>
+  #include <sys/stat.h>
+  #include <unistd.h>
+#endif
+
+using namespace framework;
+using internal::hash_bytes;
+using internal::align_up;
+
+MappedFile::MappedFile(const std::filesystem::path &path) {
+#if defined(__unix__) || defined(__APPLE__)
+  auto file = ::open(path.c_str(), O_RDONLY);
+  if (file == -1) {
+    throw std::runtime_error(std::format("Failed to open {}.", path.string()));
+  }
+
+  struct stat file_stat;
+  if (fstat(file, &file_stat) == 0 && file_stat.st_size > 0) {
+    size = file_stat.st_size;
+
+    auto address = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, file, 0);
+    if (address != MAP_FAILED) {
+      data = static_cast<const std::byte *>(address);
+      mapped = true;
+    }
+  }
+
+  ::close(file);
+
+  if (mapped) return;
+#endif
+
+  std::ifstream file_stream(path, std::ios::binary);
+  if (!file_stream) {
+    throw std::runtime_error(std::format("Failed to open {}.", path.string()));
+  }
+
+  contents.resize(std::filesystem::file_size(path));
+  file_stream.read(reinterpret_cast<char *>(contents.data()), contents.size());
+
+  data = contents.data();
+  size = contents.size();
+}
+
+MappedFile::MappedFile(MappedFile &&file) noexcept :
+  data(file.data), size(file.size), contents(std::move(file.contents)),
+  mapped(file.mapped) {
+  if (!mapped) data = contents.data();
+
+  file.data = nullptr;
+  file.size = 0;
+  file.mapped = false;
+}
+
+MappedFile &MappedFile::operator=(MappedFile &&file) noexcept {
+  std::swap(data, file.data);
+  std::swap(size, file.size);
+  std::swap(contents, file.contents);
+  std::swap(mapped, file.mapped);
+
+  return *this;
+}
+
+MappedFile::~MappedFile() {
+#if defined(__unix__) || defined(__APPLE__)
+  if (mapped) munmap(const_cast<std::byte *>(data), size);
+#endif
+}
+
+const TextureCacheHeader &CachedTexture::header() const {
+  return *reinterpret_cast<const TextureCacheHeader *>(file.data);
+}
+
+std::span<const uint8_t> CachedTexture::level(uint32_t level) const {
+  auto &cache_level = header().levels[level];
+
+  return {
+    reinterpret_cast<const uint8_t *>(file.data + cache_level.offset),
+    cache_level.size,
+  };
+}
+
+std::filesystem::path framework::textureCachePath(
+  const std::filesystem::path &cache_directory,
+  const std::string &path,
+  const TextureOptions &options
+) {
+  std::error_code error;
+  auto write_time = std::filesystem::last_write_time(path, error);
+
+  auto key = std::format(
+    "{}\n{}\n{}\n{}\n{}",
+    std::filesystem::absolute(path).string(),
+    write_time.time_since_epoch().count(),
+    static_cast<int>(options.filtering),
+    options.srgb,
+    static_cast<int>(options.mipmap_generator)
+  );
+
+  auto hash = hash_bytes(key, 0xcbf29ce484222325);
+
+  return cache_directory / std::format("{:016x}.tex", hash);
+}
+
+std::optional<CachedTexture> framework::readTextureCache(
+  const std::filesystem::path &cache_path, const TextureOptions &options
+) {
+  std::error_code error;
+  if (!std::filesystem::exists(cache_path, error)) return std::nullopt;
+
+  std::optional<MappedFile> file;
+  try {
+    file.emplace(cache_path);
+  } catch (const std::runtime_error &) {
+    return std::nullopt;
+  }
+
+  CachedTexture cached{std::move(file.value())};
+  if (cached.file.size < sizeof(TextureCacheHeader)) return std::nullopt;
+
+  auto &header = cached.header();
+  if (header.magic != TextureCacheHeader::MAGIC ||
+      header.version != TextureCacheHeader::VERSION ||
+      header.level_count == 0 ||
+      header.level_count > TextureCacheHeader::MAX_LEVELS) {
+    return std::nullopt;
+  }
+
+  // The base level is what the texture storage is created from
+  if (header.levels[0].width != header.width ||
+      header.levels[0].height != header.height) {
+    return std::nullopt;
+  }
+
+  // Driver generated levels are not stored
+  uint32_t expected_levels = 1;
+  if (options.filtering == Filtering::LinearMipmap &&
+      options.mipmap_generator == MipmapGenerator::Cpu) {
+    expected_levels = mip_level_count(header.width, header.height);
+  }
+
+  if (header.level_count != expected_levels) return std::nullopt;
+
+  for (uint32_t level = 0; level < header.level_count; level++) {
+    auto &cache_level = header.levels[level];
+    auto expected_size =
+      static_cast<uint64_t>(cache_level.width) * cache_level.height * 4;
+
+    if (cache_level.size != expected_size ||
+        cache_level.offset + cache_level.size > cached.file.size) {
+      return std::nullopt;
+    }
+  }
+
+  return cached;
+}
+
+void framework::writeTextureCache(
+  const std::filesystem::path &cache_path,
+  uint32_t width,
+  uint32_t height,
+  const uint8_t *base_pixels,
+  std::span<const MipLevel> mip_levels
+) {
+  if (mip_levels.size() + 1 > TextureCacheHeader::MAX_LEVELS) return;
+
+  TextureCacheHeader header{
+    .magic = TextureCacheHeader::MAGIC,
+    .version = TextureCacheHeader::VERSION,
+    .width = width,
+    .height = height,
+    .level_count = static_cast<uint32_t>(mip_levels.size() + 1),
+    .reserved = 0,
+    .levels = {},
+  };
+
+  std::vector<const uint8_t *> level_pixels = {base_pixels};
+  header.levels[0] = {.width = width, .height = height};
+
+  for (uint32_t level = 1; level < header.level_count; level++) {
+    auto &mip_level = mip_levels[level - 1];
+
+    level_pixels.push_back(mip_level.pixels.data());
+    header.levels[level] = {
+      .width = mip_level.width,
+      .height = mip_level.height,
+    };
+  }
+
+  uint64_t offset = align_up(sizeof(header), TextureCacheHeader::PAGE_SIZE);
+  for (uint32_t level = 0; level < header.level_count; level++) {
+    auto &cache_level = header.levels[level];
+
+    cache_level.offset = offset;
+    cache_level.size =
+      static_cast<uint64_t>(cache_level.width) * cache_level.height * 4;
+
+    offset = align_up(
+      offset + cache_level.size, TextureCacheHeader::PAGE_SIZE
+    );
+  }
+
+  std::error_code error;
+  std::filesystem::create_directories(cache_path.parent_path(), error);
+
+  // Written under another name first, so a reader never sees half a file.
+  // Loader workers may write the same entry at once, so the name is unique
+  // per thread.
+  auto thread_hash = std::hash<std::thread::id>{}(std::this_thread::get_id());
+  auto temporary_path = cache_path;
+  temporary_path += std::format(".{:x}.tmp", thread_hash);
+
+  std::ofstream file(temporary_path, std::ios::binary);
+  file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+  uint64_t written = sizeof(header);
+
+  for (uint32_t level = 0; level < header.level_count; level++) {
+    auto &cache_level = header.levels[level];
+
+    std::vector<char> padding(cache_level.offset - written, 0);
+    file.write(padding.data(), padding.size());
+    file.write(
+      reinterpret_cast<const char *>(level_pixels[level]), cache_level.size
+    );
+
+    written = cache_level.offset + cache_level.size;
+  }
+
+  file.close();
+
+  if (!file) {
+    std::cerr << "Failed to write texture cache " << cache_path << "\n";
+    std::filesystem::remove(temporary_path, error);
+    return;
+  }
+
+  std::filesystem::rename(temporary_path, cache_path, error);
+}
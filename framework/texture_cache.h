@@ -0,0 +1,95 @@
+#pragma once
+
+#include "framework/mipmap.h"
+#include "framework/texture.h"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace framework {
+  /// Read-only view of a whole file. Memory mapped on POSIX systems, read
+  /// into memory elsewhere.
+  struct MappedFile {
+    const std::byte *data = nullptr;
+    size_t size = 0;
+
+    // Holds the contents when the file could not be mapped
+    std::vector<std::byte> contents;
+
+    explicit MappedFile(const std::filesystem::path &path);
+
+    MappedFile(MappedFile &&file) noexcept;
+
+    MappedFile &operator=(MappedFile &&file) noexcept;
+
+    ~MappedFile();
+
+    MappedFile(const MappedFile &) = delete;
+
+    MappedFile &operator=(const MappedFile &) = delete;
+
+  private:
+    bool mapped = false;
+  };
+
+  struct TextureCacheLevel {
+    uint64_t offset;
+    uint64_t size;
+    uint32_t width;
+    uint32_t height;
+  };
+
+  /// Start of a cache file, followed by the RGBA8 pixels of every level.
+  /// Levels start on page boundaries so they can be uploaded straight from
+  /// the mapping.
+  struct TextureCacheHeader {
+    static constexpr std::array<char, 4> MAGIC = {'F', 'W', 'T', 'X'};
+    static constexpr uint32_t VERSION = 1;
+    static constexpr uint32_t MAX_LEVELS = 16;
+    static constexpr uint64_t PAGE_SIZE = 4096;
+
+    std::array<char, 4> magic;
+    uint32_t version;
+    uint32_t width;
+    uint32_t height;
+    uint32_t level_count;
+    uint32_t reserved;
+    std::array<TextureCacheLevel, MAX_LEVELS> levels;
+  };
+
+  struct CachedTexture {
+    MappedFile file;
+
+    const TextureCacheHeader &header() const;
+
+    std::span<const uint8_t> level(uint32_t level) const;
+  };
+
+  /// Cache file of the image at `path` with `options`, keyed by the path,
+  /// its modification time and the options that change the stored levels
+  std::filesystem::path textureCachePath(
+    const std::filesystem::path &cache_directory,
+    const std::string &path,
+    const TextureOptions &options
+  );
+
+  /// Empty when the file is missing, not a valid cache file, or doesn't
+  /// hold the levels a texture with `options` is uploaded with
+  std::optional<CachedTexture> readTextureCache(
+    const std::filesystem::path &cache_path, const TextureOptions &options
+  );
+
+  /// Stores the base level followed by `mip_levels`
+  void writeTextureCache(
+    const std::filesystem::path &cache_path,
+    uint32_t width,
+    uint32_t height,
+    const uint8_t *base_pixels,
+    std::span<const MipLevel> mip_levels
+  );
+}
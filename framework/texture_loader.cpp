@@ -0,0 +1,298 @@
+#include "texture_loader.h"
+#include <GL/glew.h>
+#include <algorithm>
+#include <array>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <span>
+
+using namespace framework;
+
+static std::shared_ptr<const Texture> create_placeholder() {
+  const std::array<stbi_uc, 4> grey = {128, 128, 128, 255};
+
+  uint32_t texture_id;
+  glCreateTextures(GL_TEXTURE_2D, 1, &texture_id);
+  glTextureStorage2D(texture_id, 1, GL_RGBA8, 1, 1);
+  glTextureSubImage2D(
+    texture_id, 0, 0, 0, 1, 1, GL_RGBA, GL_UNSIGNED_BYTE, grey.data()
+  );
+
+  return std::make_shared<const Texture>(texture_id, nullptr, grey.size());
+}
+
+static uint64_t bytes_of(const TextureLoader::DecodedImage &image) {
+  if (image.cached.has_value()) {
+    uint64_t bytes = 0;
+    for (uint32_t level = 0; level < image.cached->header().level_count;
+         level++) {
+      bytes += image.cached->level(level).size();
+    }
+
+    return bytes;
+  }
+
+  uint64_t bytes = static_cast<uint64_t>(image.width) * image.height * 4;
+  for (auto &mip_level : image.mip_levels) bytes += mip_level.pixels.size();
+
+  return bytes;
+}
+
+void AsyncTexture::bind(uint32_t unit) const {
+  if (texture.has_value()) {
+    texture->bind(unit);
+  } else {
+    placeholder->bind(unit);
+  }
+}
+
+TextureLoader::TextureLoader(uint32_t upload_budget, uint32_t worker_count) :
+  upload_budget(upload_budget),
+  staging(BufferType::PixelUnpack, upload_budget),
+  placeholder(create_placeholder()) {
+  for (uint32_t i = 0; i < std::max(worker_count, 1u); i++) {
+    workers.emplace_back([this] { run_worker(); });
+  }
+}
+
+TextureLoader::~TextureLoader() {
+  {
+    std::lock_guard lock(mutex);
+    stopping = true;
+  }
+
+  jobs_changed.notify_all();
+  for (auto &worker : workers) worker.join();
+
+  for (auto &image : decoded_images) stbi_image_free(image.pixels);
+}
+
+std::shared_ptr<AsyncTexture> TextureLoader::loadTextureAsync(
+  const std::string &path, const TextureOptions &options
+) {
+  auto texture = std::make_shared<AsyncTexture>(
+    AsyncTexture{.path = path, .placeholder = placeholder}
+  );
+
+  {
+    std::lock_guard lock(mutex);
+    jobs.push_back({.target = texture, .path = path, .options = options});
+    pending_decodes++;
+  }
+
+  jobs_changed.notify_one();
+
+  return texture;
+}
+
+void TextureLoader::run_worker() {
+  while (true) {
+    Job job;
+
+    {
+      std::unique_lock lock(mutex);
+      jobs_changed.wait(lock, [&] { return stopping || !jobs.empty(); });
+
+      if (stopping) return;
+
+      job = std::move(jobs.front());
+      jobs.pop_front();
+    }
+
+    DecodedImage image{.target = job.target, .options = job.options};
+
+    // Skip textures that were dropped while queued
+    if (!job.target.expired()) decode(job, image);
+
+    std::lock_guard lock(mutex);
+    decoded_images.push_back(std::move(image));
+    pending_decodes--;
+  }
+}
+
+void TextureLoader::decode(const Job &job, DecodedImage &image) {
+  std::optional<std::filesystem::path> cache_path;
+
+  if (job.options.cache_directory.has_value()) {
+    cache_path = textureCachePath(
+      job.options.cache_directory.value(), job.path, job.options
+    );
+
+    image.cached = readTextureCache(cache_path.value(), job.options);
+  }
+
+  if (image.cached.has_value()) {
+    auto &header = image.cached->header();
+    image.width = header.width;
+    image.height = header.height;
+
+    // Allocated like stb_image does, so it is freed the same way
+    if (job.options.keep_cpu_copy) {
+      auto base_pixels = image.cached->level(0);
+
+      image.pixels = static_cast<stbi_uc *>(std::malloc(base_pixels.size()));
+      std::memcpy(image.pixels, base_pixels.data(), base_pixels.size());
+    }
+
+    return;
+  }
+
+  int channels;
+  image.pixels = stbi_load(
+    job.path.c_str(), &image.width, &image.height, &channels, STBI_rgb_alpha
+  );
+  if (!image.pixels) return;
+
+  if (job.options.filtering == Filtering::LinearMipmap &&
+      job.options.mipmap_generator == MipmapGenerator::Cpu) {
+    std::span<const uint8_t> base_pixels(
+      image.pixels, static_cast<size_t>(image.width) * image.height * 4
+    );
+
+    image.mip_levels = build_mip_chain(
+      base_pixels, image.width, image.height, job.options.srgb
+    );
+  }
+
+  if (cache_path.has_value()) {
+    writeTextureCache(
+      cache_path.value(),
+      image.width,
+      image.height,
+      image.pixels,
+      image.mip_levels
+    );
+  }
+}
+
+void TextureLoader::upload(DecodedImage &image, bool through_staging) {
+  auto texture_id = createTexture(image.width, image.height, image.options);
+
+  uint32_t staging_offset = 0;
+  if (through_staging) {
+    staging_offset = staging.allocate(bytes_of(image));
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, staging.id);
+  }
+
+  auto upload_level = [&](
+                        uint32_t level,
+                        uint32_t width,
+                        uint32_t height,
+                        const uint8_t *pixels
+                      ) {
+    // With a pixel unpack buffer bound the pointer is an offset into it
+    const void *data = pixels;
+    if (through_staging) {
+      auto size = static_cast<size_t>(width) * height * 4;
+      std::memcpy(staging.mapped_data + staging_offset, pixels, size);
+
+      data = reinterpret_cast<const void *>(staging_offset);
+      staging_offset += size;
+    }
+
+    glTextureSubImage2D(
+      texture_id,
+      level,
+      0,
+      0,
+      width,
+      height,
+      GL_RGBA,
+      GL_UNSIGNED_BYTE,
+      data
+    );
+  };
+
+  if (image.cached.has_value()) {
+    auto &header = image.cached->header();
+
+    for (uint32_t level = 0; level < header.level_count; level++) {
+      auto &cache_level = header.levels[level];
+
+      upload_level(
+        level,
+        cache_level.width,
+        cache_level.height,
+        image.cached->level(level).data()
+      );
+    }
+
+    image.cached.reset();
+  } else {
+    upload_level(0, image.width, image.height, image.pixels);
+    for (uint32_t level = 1; level <= image.mip_levels.size(); level++) {
+      auto &mip_level = image.mip_levels[level - 1];
+
+      upload_level(
+        level, mip_level.width, mip_level.height, mip_level.pixels.data()
+      );
+    }
+  }
+
+  if (through_staging) glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+  finishTexture(texture_id, image.options);
+
+  auto target = image.target.lock();
+  if (!target) {
+    glDeleteTextures(1, &texture_id);
+    stbi_image_free(image.pixels);
+    image.pixels = nullptr;
+
+    return;
+  }
+
+  if (!image.options.keep_cpu_copy) {
+    stbi_image_free(image.pixels);
+    image.pixels = nullptr;
+  }
+
+  auto bytes = textureGpuBytes(image.width, image.height, image.options);
+  target->texture.emplace(texture_id, image.pixels, bytes);
+
+  image.pixels = nullptr;
+}
+
+void TextureLoader::update() {
+  uint64_t uploaded_bytes = 0;
+
+  while (true) {
+    DecodedImage image;
+
+    {
+      std::lock_guard lock(mutex);
+      if (decoded_images.empty()) break;
+
+      // The first image is always taken, even when it is over the budget
+      auto bytes = bytes_of(decoded_images.front());
+      if (uploaded_bytes > 0 && uploaded_bytes + bytes > upload_budget) break;
+
+      image = std::move(decoded_images.front());
+      decoded_images.pop_front();
+    }
+
+    auto target = image.target.lock();
+
+    if (!image.pixels && !image.cached.has_value()) {
+      if (target) {
+        target->failed = true;
+        std::cerr << "Failed to load texture " << target->path << "\n";
+      }
+      continue;
+    }
+
+    // Images that don't fit in the staging region are uploaded directly
+    auto bytes = bytes_of(image);
+    upload(image, staging.region_cursor + bytes <= staging.region_size);
+    uploaded_bytes += bytes;
+  }
+
+  staging.end_frame();
+}
+
+bool TextureLoader::is_idle() {
+  std::lock_guard lock(mutex);
+
+  return jobs.empty() && decoded_images.empty() && pending_decodes == 0;
+}
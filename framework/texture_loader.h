@@ -0,0 +1,105 @@
+#pragma once
+
+#include "framework/buffer.h"
+#include "framework/mipmap.h"
+#include "framework/texture.h"
+#include "framework/texture_cache.h"
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace framework {
+  /// Texture loaded in the background, binds the loader's placeholder until
+  /// it has been uploaded
+  struct AsyncTexture {
+    std::string path;
+    std::optional<Texture> texture;
+
+    // Shared so it stays valid if the handle outlives the loader
+    std::shared_ptr<const Texture> placeholder;
+
+    // Set when decoding failed, the placeholder then stays bound
+    bool failed = false;
+
+    bool is_ready() const {
+      return texture.has_value();
+    }
+
+    void bind(uint32_t unit = 0) const;
+  };
+
+  /// Decodes images on worker threads, and uploads them through a pixel
+  /// unpack buffer on the GL thread during `update`, at most
+  /// `upload_budget` bytes per frame. The copy into the unpack buffer also
+  /// happens in `update`, since its regions are fenced on the GL thread.
+  struct TextureLoader {
+    struct Job {
+      std::weak_ptr<AsyncTexture> target;
+      std::string path;
+      TextureOptions options;
+    };
+
+    struct DecodedImage {
+      std::weak_ptr<AsyncTexture> target;
+      TextureOptions options;
+      int width = 0;
+      int height = 0;
+      stbi_uc *pixels = nullptr;
+
+      // Levels after the base one, for `MipmapGenerator::Cpu`
+      std::vector<MipLevel> mip_levels;
+
+      // Set instead of the decoded levels when the image was found in the
+      // cache directory of its options, `pixels` is then only the CPU copy
+      std::optional<CachedTexture> cached;
+    };
+
+    uint32_t upload_budget;
+    StreamBuffer staging;
+    std::shared_ptr<const Texture> placeholder;
+
+    std::mutex mutex;
+    std::condition_variable jobs_changed;
+    std::deque<Job> jobs;
+    std::deque<DecodedImage> decoded_images;
+    bool stopping = false;
+    std::vector<std::thread> workers;
+
+    explicit TextureLoader(
+      uint32_t upload_budget = 16 * 1024 * 1024,
+      uint32_t worker_count = std::thread::hardware_concurrency() / 2
+    );
+
+    ~TextureLoader();
+
+    TextureLoader(const TextureLoader &) = delete;
+
+    TextureLoader &operator=(const TextureLoader &) = delete;
+
+    std::shared_ptr<AsyncTexture> loadTextureAsync(
+      const std::string &path, const TextureOptions &options = {}
+    );
+
+    /// Uploads decoded images within the budget, call once per frame
+    void update();
+
+    /// True when nothing is queued, decoding or waiting for upload
+    bool is_idle();
+
+  private:
+    uint32_t pending_decodes = 0;
+
+    void run_worker();
+
+    /// Reads `image` from the cache, or decodes it and fills the cache
+    void decode(const Job &job, DecodedImage &image);
+
+    void upload(DecodedImage &image, bool through_staging);
+  };
+}
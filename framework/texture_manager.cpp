@@ -0,0 +1,79 @@
+#include "texture_manager.h"
+#include <algorithm>
+#include <format>
+#include <vector>
+
+using namespace framework;
+
+static std::string entry_key(
+  const std::string &path, const TextureOptions &options
+) {
+  // The cache directory only changes how the texture is loaded
+  return std::format(
+    "{}\n{}\n{}\n{}\n{}\n{}",
+    path,
+    static_cast<int>(options.filtering),
+    static_cast<int>(options.wrapping),
+    options.srgb,
+    static_cast<int>(options.mipmap_generator),
+    options.keep_cpu_copy
+  );
+}
+
+TextureManager::TextureManager(uint64_t budget_bytes) :
+  budget_bytes(budget_bytes) {}
+
+const Texture &TextureManager::get(
+  const std::string &path, const TextureOptions &options
+) {
+  auto [entry, inserted] = entries.try_emplace(
+    entry_key(path, options), Entry{.path = path, .options = options}
+  );
+  auto &value = entry->second;
+
+  if (!value.texture.has_value()) {
+    value.texture.emplace(loadTexture(path, value.options));
+    resident_bytes += value.texture->gpu_bytes();
+    stats.loads++;
+  }
+
+  value.last_used_frame = frame;
+
+  return value.texture.value();
+}
+
+void TextureManager::evict(const std::string &path) {
+  for (auto &[key, entry] : entries) {
+    if (entry.path == path) evict(entry);
+  }
+}
+
+void TextureManager::evict(Entry &entry) {
+  if (!entry.texture.has_value()) return;
+
+  resident_bytes -= entry.texture->gpu_bytes();
+  entry.texture.reset();
+  stats.evictions++;
+}
+
+void TextureManager::end_frame() {
+  if (resident_bytes > budget_bytes) {
+    std::vector<std::pair<uint64_t, Entry *>> candidates;
+
+    for (auto &[key, entry] : entries) {
+      if (entry.texture.has_value() && entry.last_used_frame < frame) {
+        candidates.push_back({entry.last_used_frame, &entry});
+      }
+    }
+
+    std::ranges::sort(candidates);
+
+    for (auto [last_used_frame, entry] : candidates) {
+      if (resident_bytes <= budget_bytes) break;
+
+      evict(*entry);
+    }
+  }
+
+  frame++;
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include "framework/texture.h"
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <unordered_map>
+
+namespace framework {
+  struct TextureManagerStats {
+    uint32_t loads = 0;
+    uint32_t evictions = 0;
+  };
+
+  /// Owns textures by path and keeps their total size under `budget_bytes`
+  /// by evicting the least recently used ones, which are loaded again the
+  /// next time they are requested. Textures from a `TextureLoader` are not
+  /// owned by the manager and don't count towards the budget.
+  struct TextureManager {
+    struct Entry {
+      std::string path;
+      TextureOptions options;
+      std::optional<Texture> texture;
+      uint64_t last_used_frame = 0;
+    };
+
+    uint64_t budget_bytes;
+    uint64_t resident_bytes = 0;
+    uint64_t frame = 0;
+
+    // Keyed by the path and the options that change the texture, so the
+    // same image loaded with different options gets an entry each
+    std::unordered_map<std::string, Entry> entries;
+    TextureManagerStats stats;
+
+    explicit TextureManager(uint64_t budget_bytes);
+
+    /// Loads the texture if it isn't resident and marks it as used. The
+    /// reference stays valid until `end_frame` evicts the texture, so look
+    /// it up again every frame.
+    const Texture &get(
+      const std::string &path, const TextureOptions &options = {}
+    );
+
+    /// Frees textures until the budget is met, never ones used this frame
+    void end_frame();
+
+    /// Frees the texture at `path` for every set of options it was loaded
+    /// with
+    void evict(const std::string &path);
+
+  private:
+    void evict(Entry &entry);
+  };
+}
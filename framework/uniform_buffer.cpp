@@ -0,0 +1,28 @@
+#include "uniform_buffer.h"
+
+using namespace framework;
+
+uint32_t Std140Writer::align(uint32_t alignment) {
+  auto size = (bytes.size() + alignment - 1) / alignment * alignment;
+  bytes.resize(size, std::byte{0});
+
+  return size;
+}
+
+uint32_t Std140Writer::append(
+  const void *data, uint32_t size, uint32_t alignment
+) {
+  auto offset = align(alignment);
+
+  auto data_bytes = static_cast<const std::byte *>(data);
+  bytes.insert(bytes.end(), data_bytes, data_bytes + size);
+
+  return offset;
+}
+
+UniformBuffer::UniformBuffer(uint32_t binding, uint32_t size) :
+  buffer(BufferType::Uniform, BufferUsage::Dynamic, size), binding(binding) {}
+
+void UniformBuffer::bind() const {
+  glBindBufferBase(GL_UNIFORM_BUFFER, binding, buffer.id);
+}
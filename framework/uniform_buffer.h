@@ -0,0 +1,104 @@
+#pragma once
+
+#include "framework/buffer.h"
+#include <glm/glm.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+namespace framework {
+  /// Appends values following the std140 layout rules, each `write` returns
+  /// the offset the value was placed at
+  struct Std140Writer {
+    std::vector<std::byte> bytes;
+
+    uint32_t write(float value) {
+      return append(&value, 4, 4);
+    }
+
+    uint32_t write(int32_t value) {
+      return append(&value, 4, 4);
+    }
+
+    uint32_t write(uint32_t value) {
+      return append(&value, 4, 4);
+    }
+
+    uint32_t write(bool value) {
+      uint32_t int_value = value;
+      return append(&int_value, 4, 4);
+    }
+
+    uint32_t write(const glm::vec2 &value) {
+      return append(&value, 8, 8);
+    }
+
+    uint32_t write(const glm::ivec2 &value) {
+      return append(&value, 8, 8);
+    }
+
+    uint32_t write(const glm::vec3 &value) {
+      return append(&value, 12, 16);
+    }
+
+    uint32_t write(const glm::vec4 &value) {
+      return append(&value, 16, 16);
+    }
+
+    uint32_t write(const glm::ivec4 &value) {
+      return append(&value, 16, 16);
+    }
+
+    uint32_t write(const glm::mat4 &value) {
+      return append(&value, 64, 16);
+    }
+
+    /// Array elements are padded to a multiple of 16 bytes
+    template <typename T> uint32_t write_array(std::span<const T> values) {
+      auto offset = align(16);
+      for (auto &value : values) {
+        write(value);
+        align(16);
+      }
+
+      return offset;
+    }
+
+    /// Pads to `alignment` and returns the new size, also used to end a
+    /// nested struct
+    uint32_t align(uint32_t alignment);
+
+    uint32_t append(const void *data, uint32_t size, uint32_t alignment);
+
+    void clear() {
+      bytes.clear();
+    }
+  };
+
+  /// Uniform block data shared by every shader that binds the block to
+  /// `binding`
+  struct UniformBuffer {
+    Buffer buffer;
+    uint32_t binding;
+
+    UniformBuffer(uint32_t binding, uint32_t size);
+
+    /// `T` must be laid out like the std140 block, e.g. only `glm::mat4`
+    /// and `glm::vec4` members or explicit padding
+    template <typename T> void update(const T &block) {
+      static_assert(std::is_trivially_copyable_v<T>);
+      static_assert(std::is_standard_layout_v<T>);
+
+      buffer.updateData(std::span(&block, 1));
+    }
+
+    void update(const Std140Writer &writer) {
+      buffer.updateData(std::span(writer.bytes));
+    }
+
+    /// Binds the buffer to its binding point
+    void bind() const;
+  };
+}
@@ -0,0 +1,176 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include <glm/gtc/type_precision.hpp>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+
+namespace framework {
+  enum class VertexFormat {
+    Float1,
+    Float2,
+    Float3,
+    Float4,
+    Byte1,
+    Byte2,
+    Byte3,
+    Byte4,
+    Short1,
+    Short2,
+    Short3,
+    Short4,
+    Int1,
+    Int2,
+    Int3,
+    Int4,
+    Mat4,
+
+    // Read as floats in the shader
+    Half2,
+    Half4,
+
+    // Normalized to [0, 1] for unorm and [-1, 1] for snorm in the shader
+    UnormByte2,
+    UnormByte4,
+    SnormByte2,
+    SnormByte4,
+    UnormShort2,
+    UnormShort4,
+    SnormShort2,
+    SnormShort4,
+
+    // Three 10 bit components and a 2 bit one packed into 32 bits
+    Unorm10_10_10_2,
+    Snorm10_10_10_2,
+  };
+
+  enum class VertexStep {
+    PerVertex,
+    PerInstance,
+  };
+
+  /// Format of a vertex struct member type, only defined for types that can
+  /// be read as an attribute so anything else fails to compile
+  template <typename T> struct vertex_format_of;
+
+#define VERTEX_FORMAT_OF(Type, Format)                                         \
+  template <> struct vertex_format_of<Type> {                                  \
+    static constexpr VertexFormat value = VertexFormat::Format;                \
+  };
+
+  VERTEX_FORMAT_OF(float, Float1)
+  VERTEX_FORMAT_OF(glm::vec2, Float2)
+  VERTEX_FORMAT_OF(glm::vec3, Float3)
+  VERTEX_FORMAT_OF(glm::vec4, Float4)
+  VERTEX_FORMAT_OF(uint8_t, Byte1)
+  VERTEX_FORMAT_OF(glm::u8vec2, Byte2)
+  VERTEX_FORMAT_OF(glm::u8vec3, Byte3)
+  VERTEX_FORMAT_OF(glm::u8vec4, Byte4)
+  VERTEX_FORMAT_OF(uint16_t, Short1)
+  VERTEX_FORMAT_OF(glm::u16vec2, Short2)
+  VERTEX_FORMAT_OF(glm::u16vec3, Short3)
+  VERTEX_FORMAT_OF(glm::u16vec4, Short4)
+  VERTEX_FORMAT_OF(uint32_t, Int1)
+  VERTEX_FORMAT_OF(glm::uvec2, Int2)
+  VERTEX_FORMAT_OF(glm::uvec3, Int3)
+  VERTEX_FORMAT_OF(glm::uvec4, Int4)
+  VERTEX_FORMAT_OF(glm::mat4, Mat4)
+
+#undef VERTEX_FORMAT_OF
+
+  template <typename T>
+  constexpr VertexFormat vertex_format_of_v = vertex_format_of<T>::value;
+
+  /// Attribute read from `offset` into `layout(location = N)` of the shader
+  struct LayoutAttribute {
+    uint32_t location;
+    VertexFormat format;
+    uint32_t offset;
+    uint32_t size;
+  };
+
+  /// Attributes of one vertex buffer, type erased so layouts of different
+  /// structs can be passed together
+  struct VertexBufferLayout {
+    uint32_t stride;
+    std::span<const LayoutAttribute> attributes;
+    VertexStep step = VertexStep::PerVertex;
+    uint32_t step_rate = 1;
+  };
+
+  template <size_t N> struct VertexLayout {
+    uint32_t stride;
+    std::array<LayoutAttribute, N> attributes;
+    VertexStep step = VertexStep::PerVertex;
+    uint32_t step_rate = 1;
+
+    /// Same layout, read once per `step_rate` instances instead
+    constexpr VertexLayout per_instance(uint32_t step_rate = 1) const {
+      auto layout = *this;
+      layout.step = VertexStep::PerInstance;
+      layout.step_rate = step_rate;
+
+      return layout;
+    }
+
+    operator VertexBufferLayout() const {
+      return {
+        .stride = stride,
+        .attributes = attributes,
+        .step = step,
+        .step_rate = step_rate,
+      };
+    }
+  };
+
+  /// Layout of the vertex struct `T`, the attributes come from
+  /// `VERTEX_ATTRIBUTE`. Overlapping members or reused locations are
+  /// compile errors when used in a constant expression.
+  template <typename T, typename... Attributes>
+  consteval VertexLayout<sizeof...(Attributes)> vertex_layout_of(
+    Attributes... attributes
+  ) {
+    static_assert(std::is_standard_layout_v<T>);
+    static_assert((std::is_same_v<Attributes, LayoutAttribute> && ...));
+
+    VertexLayout<sizeof...(Attributes)> layout{
+      .stride = sizeof(T),
+      .attributes = {attributes...},
+    };
+
+    for (size_t i = 0; i < layout.attributes.size(); i++) {
+      for (size_t j = i + 1; j < layout.attributes.size(); j++) {
+        auto &first = layout.attributes[i];
+        auto &second = layout.attributes[j];
+        using enum VertexFormat;
+
+        // Matrices take one location per column
+        auto first_end = first.location + (first.format == Mat4 ? 4 : 1);
+        auto second_end = second.location + (second.format == Mat4 ? 4 : 1);
+
+        if (first.location < second_end && second.location < first_end) {
+          throw std::logic_error("Vertex attribute location is reused.");
+        }
+
+        if (first.offset < second.offset + second.size &&
+            second.offset < first.offset + first.size) {
+          throw std::logic_error("Vertex attributes overlap.");
+        }
+      }
+    }
+
+    return layout;
+  }
+}
+
+/// Attribute of `Type::member` at `layout(location = location_)`
+#define VERTEX_ATTRIBUTE(Type, member, location_)                              \
+  framework::LayoutAttribute {                                                 \
+    .location = location_,                                                     \
+    .format = framework::vertex_format_of_v<decltype(Type::member)>,           \
+    .offset = offsetof(Type, member), .size = sizeof(Type::member),            \
+  }
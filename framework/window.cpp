@@ -1,4 +1,5 @@
 #include "window.h"
+#include "render_state.h"
 #include <ios>
 #include <iostream>
 
@@ -63,6 +64,9 @@ Window::Window(
 
   glGetIntegerv(GL_FRAMEBUFFER_BINDING, &default_framebuffer);
 
+  // Nothing tracked so far applies to the new context
+  RenderState::current().invalidate();
+
   std::cout << "Vendor: " << glGetString(GL_VENDOR) << "\n";
   std::cout << "Renderer: " << glGetString(GL_RENDERER) << "\n";
   std::cout << "OpenGL version: " << glGetString(GL_VERSION) << "\n";
@@ -138,6 +142,8 @@ void Window::begin_default_pass(optional<Clear> pass_action) const {
 }
 
 void Window::commit_frame() const {
+  RenderState::current().end_frame();
+
   glfwSwapBuffers(glfw_window);
   glfwPollEvents();
 }
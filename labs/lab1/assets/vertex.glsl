@@ -1,7 +1,7 @@
 #version 430 core
 
-in vec2 position;
-in vec3 color;
+layout(location = 0) in vec2 position;
+layout(location = 1) in vec3 color;
 
 out VertexData {
     vec3 color;
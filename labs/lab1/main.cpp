@@ -25,6 +25,10 @@ struct Vertex {
   glm::vec3 color;
 };
 
+constexpr auto VERTEX_LAYOUT = vertex_layout_of<Vertex>(
+  VERTEX_ATTRIBUTE(Vertex, position, 0), VERTEX_ATTRIBUTE(Vertex, color, 1)
+);
+
 float repeat(float t, float length) {
   return glm::clamp(t - glm::floor(t / length) * length, 0.f, length);
 };
@@ -52,12 +56,10 @@ int main(int argc, char *argv[]) {
 
   auto indices = shapes::triangle.indices;
 
-  Buffer vertex_buffer(
-    BufferType::Vertex, BufferUsage::Dynamic, std::span(vertices)
-  );
-  Buffer index_buffer(
-    BufferType::Index, BufferUsage::Static, std::span(indices)
+  StreamBuffer vertex_buffer(
+    BufferType::Vertex, sizeof(Vertex) * vertices.size()
   );
+  Buffer index_buffer(BufferUsage::Static, indices);
 
   auto vertex_shader_path = assets_folder / "vertex.glsl";
   auto fragment_shader_path = assets_folder / "fragment.glsl";
@@ -65,11 +67,7 @@ int main(int argc, char *argv[]) {
   auto shader =
     std::make_shared<Shader>(vertex_shader_path, fragment_shader_path);
 
-  auto attributes = {
-    VertexAttribute{.name = "position", .format = VertexFormat::Float2},
-    VertexAttribute{.name = "color", .format = VertexFormat::Float3},
-  };
-  Pipeline pipeline(shader, attributes);
+  Pipeline pipeline(shader, {VERTEX_LAYOUT});
 
   while (!window.should_close()) {
     auto time = window.time();
@@ -78,7 +76,7 @@ int main(int argc, char *argv[]) {
 
     // rainbow based on time, each vertex
     for (auto const [index, vertex] : views::enumerate(vertices)) {
-      // auto hue = (float)index * (360.f / amount) + time * 50.f;
+      auto hue = (float)index * (360.f / amount) + time * 50.f;
 
       vertex.color = glm::rgbColor(glm::vec3{hue, 1.f, 1.f});
       // auto red = index % 3 == 0 ? 1.0f : 0.0f;
@@ -91,14 +89,16 @@ int main(int argc, char *argv[]) {
       //   (glm::cos(blue + (time / 1.f)) + 1.f) / 2.f
       // };
     }
-    vertex_buffer.updateData(std::span(vertices));
+    auto vertex_offset = vertex_buffer.write(std::span(vertices));
 
     window.begin_default_pass(Clear{.color = array{0.5f, 0.0f, 0.0f, 1.0f}});
 
     pipeline.bind();
-    pipeline.bind_buffers({std::ref(vertex_buffer)}, index_buffer);
+    pipeline.bind_buffers({{vertex_buffer.id, vertex_offset}}, index_buffer);
     pipeline.draw(indices.size());
 
+    vertex_buffer.end_frame();
+
     window.commit_frame();
 
     if (window.get_key(GLFW_KEY_ESCAPE) == GLFW_PRESS) break;
@@ -22,6 +22,9 @@ struct Vertex {
   glm::vec2 position;
 };
 
+constexpr auto VERTEX_LAYOUT =
+  vertex_layout_of<Vertex>(VERTEX_ATTRIBUTE(Vertex, position, 0));
+
 const glm::ivec2 BOARD_TILES = {10, 10};
 
 int main(int argc, char *argv[]) {
@@ -44,9 +47,7 @@ int main(int argc, char *argv[]) {
   Buffer vertex_buffer(
     BufferType::Vertex, BufferUsage::Static, std::span(vertices)
   );
-  Buffer index_buffer(
-    BufferType::Index, BufferUsage::Static, std::span(indices)
-  );
+  Buffer index_buffer(BufferUsage::Static, indices);
 
   auto vertex_shader_path = assets_folder / "vertex.glsl";
   auto fragment_shader_path = assets_folder / "fragment.glsl";
@@ -54,15 +55,14 @@ int main(int argc, char *argv[]) {
   auto shader =
     std::make_shared<Shader>(vertex_shader_path, fragment_shader_path);
 
-  auto attributes = {
-    VertexAttribute{.name = "position", .format = VertexFormat::Float2},
-  };
-  Pipeline pipeline(shader, attributes);
+  Pipeline pipeline(shader, {VERTEX_LAYOUT});
+
+  auto board_tiles_uniform = shader->uniform("board_tiles");
 
   while (!window.should_close()) {
     window.begin_default_pass(Clear{.color = array{0.5f, 0.0f, 0.0f, 1.0f}});
 
-    shader->uploadUniformInt2("board_tiles", BOARD_TILES);
+    shader->uploadUniformInt2(board_tiles_uniform, BOARD_TILES);
 
     pipeline.bind();
     pipeline.bind_buffers({std::ref(vertex_buffer)}, index_buffer);
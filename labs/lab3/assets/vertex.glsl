@@ -1,13 +1,16 @@
 #version 430 core
 
-in vec2 position;
+layout(location = 0) in vec2 position;
 
 out VertexData {
     vec2 grid_position;
 } vertex_data;
 
-uniform mat4 projection_matrix;
-uniform mat4 view_matrix;
+layout(std140) uniform Camera {
+    mat4 projection_matrix;
+    mat4 view_matrix;
+};
+
 uniform mat4 model_matrix;
 
 void main() {
@@ -1,6 +1,8 @@
 #include "framework/ranges.h"
+#include "framework/shader_watcher.h"
 #include "framework/shapes.h"
-#include "framework/texture.h"
+#include "framework/texture_loader.h"
+#include "framework/uniform_buffer.h"
 #include <framework/buffer.h>
 #include <framework/pipeline.h>
 #include <framework/shader.h>
@@ -24,16 +26,38 @@ struct Vertex {
   glm::vec2 position;
 };
 
+constexpr auto VERTEX_LAYOUT =
+  vertex_layout_of<Vertex>(VERTEX_ATTRIBUTE(Vertex, position, 0));
+
+// Matches the std140 `Camera` block in vertex.glsl
+struct CameraBlock {
+  glm::mat4 projection_matrix;
+  glm::mat4 view_matrix;
+};
+
 const glm::ivec2 BOARD_TILES = {10, 10};
+const uint32_t CAMERA_BINDING = 0;
 
 int main(int argc, char *argv[]) {
   path program_path(argv[0]);
   path program_folder = program_path.parent_path();
   path assets_folder = program_folder / "assets";
 
+  // Shaders are read from the source tree so edits there are hot reloaded,
+  // the copy next to the executable only changes when rebuilding
+#ifdef LAB3_ASSET_DIR
+  path shader_folder = LAB3_ASSET_DIR;
+#else
+  path shader_folder = assets_folder;
+#endif
+
   Window window(800, 600, "Lab 3", false);
 
-  auto texture = loadTexture(assets_folder / "diffuse.jpg");
+  TextureLoader texture_loader;
+  auto texture = texture_loader.loadTextureAsync(
+    assets_folder / "diffuse.jpg",
+    TextureOptions{.cache_directory = program_folder / "texture_cache"}
+  );
 
   auto grid = shapes::grid(BOARD_TILES.x, BOARD_TILES.y);
 
@@ -48,20 +72,29 @@ int main(int argc, char *argv[]) {
   Buffer vertex_buffer(
     BufferType::Vertex, BufferUsage::Static, std::span(vertices)
   );
-  Buffer index_buffer(
-    BufferType::Index, BufferUsage::Static, std::span(indices)
+  Buffer index_buffer(BufferUsage::Static, indices);
+
+  auto vertex_shader_path = shader_folder / "vertex.glsl";
+  auto fragment_shader_path = shader_folder / "fragment.glsl";
+
+  auto shader = std::make_shared<Shader>(
+    vertex_shader_path,
+    fragment_shader_path,
+    ShaderOptions{.binary_cache_directory = program_folder / "shader_cache"}
   );
 
-  auto vertex_shader_path = assets_folder / "vertex.glsl";
-  auto fragment_shader_path = assets_folder / "fragment.glsl";
+  Pipeline pipeline(shader, {VERTEX_LAYOUT});
+
+  ShaderWatcher shader_watcher;
+  shader_watcher.watch(shader);
+
+  UniformBuffer camera_buffer(CAMERA_BINDING, sizeof(CameraBlock));
+  shader->bind_uniform_block("Camera", CAMERA_BINDING);
 
-  auto shader =
-    std::make_shared<Shader>(vertex_shader_path, fragment_shader_path);
+  auto model_matrix_uniform = shader->uniform("model_matrix");
+  auto board_tiles_uniform = shader->uniform("board_tiles");
+  auto selected_tile_uniform = shader->uniform("selected_tile");
 
-  auto attributes = {
-    VertexAttribute{.name = "position", .format = VertexFormat::Float2},
-  };
-  Pipeline pipeline(shader, attributes);
   auto static selected_tile = glm::ivec2(5, 5);
 
   glfwSetKeyCallback(
@@ -83,6 +116,9 @@ int main(int argc, char *argv[]) {
   );
 
   while (!window.should_close()) {
+    shader_watcher.poll();
+    texture_loader.update();
+
     auto fov = glm::radians(45.0f);
     auto aspect_ratio = window.get_aspect_ratio();
     auto z_near = 0.1f;
@@ -100,18 +136,22 @@ int main(int argc, char *argv[]) {
     // TODO camera
     window.begin_default_pass(Clear{.color = array{0.5f, 0.0f, 0.0f, 1.0f}});
 
-    shader->uploadUniformMatrix4("projection_matrix", projection_matrix);
-    shader->uploadUniformMatrix4("view_matrix", view_matrix);
-    shader->uploadUniformMatrix4("model_matrix", model_matrix);
+    camera_buffer.update(CameraBlock{
+      .projection_matrix = projection_matrix,
+      .view_matrix = view_matrix,
+    });
+    camera_buffer.bind();
+
+    shader->uploadUniformMatrix4(model_matrix_uniform, model_matrix);
 
-    shader->uploadUniformInt2("board_tiles", BOARD_TILES);
-    shader->uploadUniformInt2("selected_tile", selected_tile);
+    shader->uploadUniformInt2(board_tiles_uniform, BOARD_TILES);
+    shader->uploadUniformInt2(selected_tile_uniform, selected_tile);
 
     pipeline.bind();
     pipeline.bind_buffers({std::ref(vertex_buffer)}, index_buffer);
     pipeline.draw(indices.size());
 
-    texture.bind();
+    texture->bind();
 
     window.commit_frame();
 
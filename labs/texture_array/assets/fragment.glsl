@@ -0,0 +1,13 @@
+#version 430 core
+
+in VertexData {
+    vec3 texture_coordinate;
+} vertex_data;
+
+out vec4 color;
+
+layout(binding = 0) uniform sampler2DArray images;
+
+void main() {
+    color = texture(images, vertex_data.texture_coordinate);
+}
@@ -0,0 +1,25 @@
+#version 430 core
+
+layout(location = 0) in vec2 position;
+layout(location = 1) in vec2 texture_coordinate;
+
+// Per instance
+layout(location = 2) in vec2 screen_offset;
+layout(location = 3) in vec4 region;
+layout(location = 4) in float layer;
+
+out VertexData {
+    vec3 texture_coordinate;
+} vertex_data;
+
+const float QUAD_SIZE = 0.45;
+
+void main() {
+    gl_Position = vec4(position * QUAD_SIZE + screen_offset, 0.0, 1.0);
+
+    // Images are stored top row first
+    vec2 uv = vec2(texture_coordinate.x, 1.0 - texture_coordinate.y);
+
+    // `region` holds the uv offset in xy and the uv scale in zw
+    vertex_data.texture_coordinate = vec3(region.xy + uv * region.zw, layer);
+}
@@ -0,0 +1,126 @@
+#include "framework/ranges.h"
+#include "framework/shapes.h"
+#include "framework/texture_array.h"
+#include <framework/buffer.h>
+#include <framework/pipeline.h>
+#include <framework/shader.h>
+#include <framework/window.h>
+#include <glm/glm.hpp>
+#include <cstdlib>
+#include <filesystem>
+#include <ranges>
+#include <span>
+#include <string>
+#include <vector>
+
+using namespace framework;
+using std::array;
+using std::string;
+using std::filesystem::path;
+namespace views = std::views;
+
+struct Vertex {
+  glm::vec2 position;
+  glm::vec2 texture_coordinate;
+};
+
+// One per image, says where to draw it and where it is in the array
+struct Instance {
+  glm::vec2 screen_offset;
+  glm::vec4 region;
+  float layer;
+};
+
+constexpr auto VERTEX_LAYOUT = vertex_layout_of<Vertex>(
+  VERTEX_ATTRIBUTE(Vertex, position, 0),
+  VERTEX_ATTRIBUTE(Vertex, texture_coordinate, 1)
+);
+
+constexpr auto INSTANCE_LAYOUT = vertex_layout_of<Instance>(
+  VERTEX_ATTRIBUTE(Instance, screen_offset, 2),
+  VERTEX_ATTRIBUTE(Instance, region, 3),
+  VERTEX_ATTRIBUTE(Instance, layer, 4)
+).per_instance();
+
+const array<string, 4> IMAGES = {
+  "cat.png",
+  "dog.png",
+  "floor_texture.png",
+  "cube_texture.png",
+};
+
+int main(int argc, char *argv[]) {
+  path program_path(argv[0]);
+  path program_folder = program_path.parent_path();
+  path assets_folder = program_folder / "assets";
+
+  Window window(800, 600, "Texture array", false);
+
+  // The images differ in size, so some share a layer and the large one
+  // gets its own. All of them are drawn from a single texture binding.
+  TextureArrayBuilder builder;
+  std::vector<uint32_t> regions;
+  for (auto &image : IMAGES) {
+    regions.push_back(builder.add(assets_folder / "textures" / image));
+  }
+
+  auto texture_array = builder.build();
+
+  // clang-format off
+  auto vertices = shapes::quad.vertices
+    | views::transform([](auto v) {
+        return Vertex{
+          .position = v.position.xy(),
+          .texture_coordinate = v.texture_coordinate
+        };
+    })
+    | to<std::vector<Vertex>>();
+  // clang-format on
+
+  auto indices = shapes::quad.indices;
+
+  std::vector<Instance> instances;
+  for (auto [index, region_index] : views::enumerate(regions)) {
+    auto &region = texture_array.regions[region_index];
+
+    instances.push_back({
+      .screen_offset = {-0.75f + index * 0.5f, 0.0f},
+      .region = glm::vec4(region.uv_offset, region.uv_scale),
+      .layer = static_cast<float>(region.layer),
+    });
+  }
+
+  Buffer vertex_buffer(
+    BufferType::Vertex, BufferUsage::Static, std::span(vertices)
+  );
+  Buffer instance_buffer(
+    BufferType::Vertex, BufferUsage::Static, std::span(instances)
+  );
+  Buffer index_buffer(BufferUsage::Static, indices);
+
+  auto vertex_shader_path = assets_folder / "vertex.glsl";
+  auto fragment_shader_path = assets_folder / "fragment.glsl";
+
+  auto shader =
+    std::make_shared<Shader>(vertex_shader_path, fragment_shader_path);
+
+  Pipeline pipeline(shader, {VERTEX_LAYOUT, INSTANCE_LAYOUT});
+
+  while (!window.should_close()) {
+    window.begin_default_pass(Clear{.color = array{0.2f, 0.2f, 0.2f, 1.0f}});
+
+    texture_array.bind(0);
+
+    pipeline.bind();
+    pipeline.bind_buffers(
+      {std::ref(vertex_buffer), std::ref(instance_buffer)}, index_buffer
+    );
+    pipeline.draw_instanced(indices.size(), instances.size());
+
+    window.commit_frame();
+
+    if (window.get_key(GLFW_KEY_ESCAPE) == GLFW_PRESS) break;
+  }
+
+  return EXIT_SUCCESS;
+}